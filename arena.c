@@ -0,0 +1,77 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file arena.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Implementation of arena allocator (bump allocation in linked blocks)
+ */
+
+#include "arena.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include "error.h"
+
+#define ALIGN alignof(max_align_t)
+
+struct arena_block {
+    struct arena_block* next;  // Previous (older) block
+    size_t used;               // Used bytes
+    size_t size;               // Capacity
+    alignas(max_align_t) char data[];
+};
+
+arena_t* arena_new() {
+    arena_t* arena = malloc(sizeof(arena_t));
+    if (arena == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    arena->block = NULL;
+    arena->used = 0;
+    return arena;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+    if (arena->block == NULL || arena->block->used + size > arena->block->size) {
+        size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        arena_block_t* block = malloc(sizeof(arena_block_t) + block_size);
+        if (block == NULL) {
+            error_exit(ERR_INTERNAL);
+        }
+        block->next = arena->block;
+        block->used = 0;
+        block->size = block_size;
+        arena->block = block;
+    }
+    void* ptr = arena->block->data + arena->block->used;
+    arena->block->used += size;
+    arena->used += size;
+    return ptr;
+}
+
+void arena_reset(arena_t* arena) {
+    if (arena->block == NULL) {
+        return;
+    }
+    arena_block_t* block = arena->block->next;
+    while (block != NULL) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->block->next = NULL;
+    arena->block->used = 0;
+    arena->used = 0;
+}
+
+void arena_free(arena_t* arena) {
+    if (arena == NULL) {
+        return;
+    }
+    arena_reset(arena);
+    free(arena->block);
+    free(arena);
+}
@@ -0,0 +1,60 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file arena.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for arena allocator
+ *
+ * Data with the same lifetime (whole program, one function, one expression) is allocated from
+ * one arena and released all at once, nothing is freed individually.
+ */
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+// Default block size (bigger allocations get their own block)
+#define ARENA_BLOCK_SIZE 16384
+
+typedef struct arena_block arena_block_t;
+
+typedef struct {
+    arena_block_t* block;  // Current block (head of the list, NULL if nothing was allocated)
+    size_t used;           // Bytes allocated since last reset
+} arena_t;
+
+/**
+ * @brief Create new empty arena (blocks are allocated on first use)
+ *
+ * @return Arena
+ */
+arena_t* arena_new();
+
+/**
+ * @brief Allocate memory from arena (aligned for any type, valid until reset or free)
+ *
+ * @param arena Arena
+ * @param size Number of bytes
+ * @return Pointer to memory
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**
+ * @brief Release everything allocated from arena (current block is kept for reuse)
+ *
+ * @param arena Arena
+ */
+void arena_reset(arena_t* arena);
+
+/**
+ * @brief Free arena and all its blocks
+ *
+ * @param arena Arena
+ */
+void arena_free(arena_t* arena);
+
+#endif  // __ARENA_H__
@@ -0,0 +1,115 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Shared helpers for benchmarks (timing, synthetic programs)
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Growable output buffer for generated programs
+typedef struct {
+    char* val;
+    size_t len;
+    size_t size;
+} bench_buf_t;
+
+/**
+ * @brief Current time in seconds (monotonic)
+ */
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Append formatted text to buffer
+ */
+static inline void bench_printf(bench_buf_t* buf, const char* fmt, ...) {
+    while (true) {
+        va_list args;
+        va_start(args, fmt);
+        size_t free_space = buf->size - buf->len;
+        int n = vsnprintf(buf->val + buf->len, free_space, fmt, args);
+        va_end(args);
+        if (n >= 0 && (size_t)n < free_space) {
+            buf->len += n;
+            return;
+        }
+        buf->size = buf->size ? buf->size * 2 : 4096;
+        buf->val = realloc(buf->val, buf->size);
+        if (buf->val == NULL) {
+            exit(99);
+        }
+    }
+}
+
+/**
+ * @brief Generate valid IFJ22 program consisting of functions and statements
+ *
+ * @param statements Number of top level statements
+ * @return Program source (caller frees val)
+ */
+static inline bench_buf_t bench_program(size_t statements) {
+    bench_buf_t buf = {0};
+    bench_printf(&buf, "<?php\ndeclare(strict_types=1);\n");
+    for (size_t i = 0; i < statements; i++) {
+        switch (i % 8) {
+            case 0:
+                bench_printf(&buf, "function fun_%zu(int $a, ?float $b, string $text): int {\n", i);
+                bench_printf(&buf, "    /* Function number %zu with a short comment */\n", i);
+                bench_printf(&buf, "    $result = $a * 2 + 17 - $a / 3;\n");
+                bench_printf(&buf, "    return $result;\n}\n");
+                break;
+            case 1:
+                bench_printf(&buf, "$variable_%zu = %zu + 42 * ($counter - 3);\n", i % 64, i);
+                break;
+            case 2:
+                bench_printf(&buf, "// Line comment explaining statement %zu\n", i);
+                bench_printf(&buf, "$text = \"Hello world number %zu\\n\" . $text;\n", i);
+                break;
+            case 3:
+                bench_printf(&buf, "if ($counter < %zu) {\n    $counter = $counter + 1;\n", i);
+                bench_printf(&buf, "} else {\n    $counter = $counter - 1;\n}\n");
+                break;
+            case 4:
+                bench_printf(&buf, "$float_value = 3.14159e2 * %zu.5 + 0.125;\n", i);
+                break;
+            case 5:
+                bench_printf(&buf, "while ($counter > 100) {\n    $counter = $counter - 7;\n}\n");
+                break;
+            case 6:
+                bench_printf(&buf, "$other = fun_%zu($counter, 2.5, \"argument\");\n", i - 6);
+                break;
+            case 7:
+                bench_printf(&buf, "write($text, \"\\n\", $counter, \"\\n\");\n");
+                break;
+        }
+    }
+    bench_printf(&buf, "?>\n");
+    return buf;
+}
+
+/**
+ * @brief Print one benchmark result line
+ */
+static inline void bench_report(const char* name, size_t bytes, double seconds) {
+    printf("%-40s %10.3f ms %10.1f MB/s\n", name, seconds * 1e3, bytes / seconds / 1e6);
+}
+
+#endif  // __BENCH_H__
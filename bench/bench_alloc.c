@@ -0,0 +1,110 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_alloc.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Number of heap allocations and end-to-end compile time (without output) of examples and of
+ * a large program
+ *
+ * Allocator functions are replaced by counting wrappers around the glibc ones.
+ */
+
+#include "bench.h"
+#include <glob.h>
+#include "../gen.h"
+#include "../intern.h"
+#include "../parser.h"
+#include "../scanner.h"
+
+#define STATEMENTS 100000
+
+// Original glibc allocator
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+static bool counting = false;
+static size_t allocations = 0;
+static size_t reallocations = 0;
+
+void* malloc(size_t size) {
+    allocations += counting;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    allocations += counting;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr == NULL) {
+        allocations += counting;
+    } else {
+        reallocations += counting;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+/**
+ * @brief Compile program (without output) and print number of allocations and time
+ */
+static void compile(const char* name, const char* program, size_t len) {
+    allocations = 0;
+    reallocations = 0;
+    counting = true;
+    double start = bench_now();
+    scanner_t scanner = scanner_new_from_buffer(program, len);
+    gen_t gen = gen_new();
+    parser_t parser = parser_new(&scanner, &gen);
+    parser_run(&parser);
+    parser_free(&parser);
+    gen_free(&gen);
+    scanner_free(&scanner);
+    intern_free();
+    double time = bench_now() - start;
+    counting = false;
+    printf("%-40s %10zu allocations %10zu reallocations %10.3f ms\n", name, allocations,
+           reallocations, time * 1e3);
+}
+
+int main() {
+    glob_t files;
+    if (glob("examples/*.php", 0, NULL, &files) == 0) {
+        for (size_t i = 0; i < files.gl_pathc; i++) {
+            // Helper file is not a standalone program
+            if (strstr(files.gl_pathv[i], "ifj22.php") != NULL) {
+                continue;
+            }
+            FILE* file = fopen(files.gl_pathv[i], "rb");
+            if (file == NULL) {
+                continue;
+            }
+            bench_buf_t program = {0};
+            char chunk[4096];
+            size_t n;
+            while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+                bench_printf(&program, "%.*s", (int)n, chunk);
+            }
+            fclose(file);
+            compile(files.gl_pathv[i], program.val, program.len);
+            free(program.val);
+        }
+        globfree(&files);
+    }
+
+    bench_buf_t program = bench_program(STATEMENTS);
+    char name[64];
+    snprintf(name, sizeof(name), "synthetic (%d statements)", STATEMENTS);
+    compile(name, program.val, program.len);
+    free(program.val);
+    return 0;
+}
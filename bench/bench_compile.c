@@ -0,0 +1,50 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_compile.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Whole compilation (scanner, parser, generator) over growing programs, time per statement
+ * has to stay roughly constant
+ */
+
+#include "bench.h"
+#include "../gen.h"
+#include "../parser.h"
+#include "../scanner.h"
+
+#define ROUNDS 3
+
+int main() {
+    const size_t sizes[] = {1000, 10000, 100000};
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            bench_buf_t program = bench_program(sizes[i]);
+
+            double start = bench_now();
+            scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+            gen_t gen = gen_new();
+            parser_t parser = parser_new(&scanner, &gen);
+            parser_run(&parser);
+            double time = bench_now() - start;
+            size_t output = (gen.header.len + gen.global.len) * sizeof(ir_instr_t) +
+                            gen.global_text.len + gen.functions_text.len;
+
+            char name[64];
+            snprintf(name, sizeof(name), "%zu statements (%.0f ns/statement)", sizes[i],
+                     time / sizes[i] * 1e9);
+            bench_report(name, program.len, time);
+            printf("%-40s %10.1f MB\n", "  generated code (instructions)", output / 1e6);
+
+            parser_free(&parser);
+            gen_free(&gen);
+            scanner_free(&scanner);
+            free(program.val);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_exp.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Compile time of long expressions (flat ones and deeply parenthesized ones)
+ */
+
+#include "bench.h"
+#include "../gen.h"
+#include "../parser.h"
+#include "../scanner.h"
+
+#define OPERANDS 10000
+#define EXPRESSIONS 50
+#define ROUNDS 3
+
+/**
+ * @brief Generate program with long expressions
+ *
+ * @param shape 0 = flat with mixed precedence, 1 = left nested parentheses, 2 = right nested
+ * parentheses
+ */
+static bench_buf_t exp_program(int shape) {
+    static const char* operators[] = {"+", "*", "-", "/", "."};
+    bench_buf_t buf = {0};
+    bench_printf(&buf, "<?php\ndeclare(strict_types=1);\n$a = 1;\n");
+    for (int i = 0; i < EXPRESSIONS; i++) {
+        bench_printf(&buf, "$x = ");
+        if (shape == 1) {
+            for (int j = 1; j < OPERANDS; j++) {
+                bench_printf(&buf, "(");
+            }
+        }
+        bench_printf(&buf, "$a");
+        for (int j = 1; j < OPERANDS; j++) {
+            const char* op = operators[j % 5];
+            if (shape == 0) {
+                bench_printf(&buf, " %s %d", op, j);
+            } else if (shape == 1) {
+                bench_printf(&buf, " %s %d)", op, j);
+            } else {
+                bench_printf(&buf, " %s (%d", op, j);
+            }
+        }
+        if (shape == 2) {
+            for (int j = 1; j < OPERANDS; j++) {
+                bench_printf(&buf, ")");
+            }
+        }
+        bench_printf(&buf, ";\n");
+    }
+    return buf;
+}
+
+int main() {
+    const char* names[] = {"flat", "nested (left)", "nested (right)"};
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int shape = 0; shape < 3; shape++) {
+            bench_buf_t program = exp_program(shape);
+
+            double start = bench_now();
+            scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+            gen_t gen = gen_new();
+            parser_t parser = parser_new(&scanner, &gen);
+            parser_run(&parser);
+            double time = bench_now() - start;
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s (%.0f ns/operand)", names[shape],
+                     time / (EXPRESSIONS * OPERANDS) * 1e9);
+            bench_report(name, program.len, time);
+
+            parser_free(&parser);
+            gen_free(&gen);
+            scanner_free(&scanner);
+            free(program.val);
+        }
+        printf("\n");
+    }
+    return 0;
+}
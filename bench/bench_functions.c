@@ -0,0 +1,70 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_functions.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Compile time of programs with many tiny functions (local symbol table is reset after
+ * each of them)
+ */
+
+#include "bench.h"
+#include "../gen.h"
+#include "../intern.h"
+#include "../parser.h"
+#include "../scanner.h"
+
+#define FUNCTIONS 50000
+#define BIG_LOCALS 2000
+#define ROUNDS 3
+
+/**
+ * @brief Generate program with tiny functions
+ *
+ * @param big Whether the first function has BIG_LOCALS local variables
+ */
+static bench_buf_t functions_program(bool big) {
+    bench_buf_t buf = {0};
+    bench_printf(&buf, "<?php\ndeclare(strict_types=1);\n");
+    if (big) {
+        bench_printf(&buf, "function big(int $a): int {\n");
+        for (int i = 0; i < BIG_LOCALS; i++) {
+            bench_printf(&buf, "    $local_%d = $a;\n", i);
+        }
+        bench_printf(&buf, "    return $a;\n}\n");
+    }
+    for (int i = 0; i < FUNCTIONS; i++) {
+        bench_printf(&buf, "function f%d(int $a, int $b): int {\n", i);
+        bench_printf(&buf, "    $c = $a + $b;\n    return $c;\n}\n");
+    }
+    bench_printf(&buf, "$x = f0(1, 2);\n");
+    return buf;
+}
+
+int main() {
+    const char* names[] = {"50k tiny functions", "big function + 50k tiny"};
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int shape = 0; shape < 2; shape++) {
+            bench_buf_t program = functions_program(shape == 1);
+
+            double start = bench_now();
+            scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+            gen_t gen = gen_new();
+            parser_t parser = parser_new(&scanner, &gen);
+            parser_run(&parser);
+            double time = bench_now() - start;
+            bench_report(names[shape], program.len, time);
+
+            parser_free(&parser);
+            gen_free(&gen);
+            scanner_free(&scanner);
+            intern_free();
+            free(program.val);
+        }
+        printf("\n");
+    }
+    return 0;
+}
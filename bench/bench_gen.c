@@ -0,0 +1,95 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_gen.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Compile time and peak memory of programs with thousands of functions (including output),
+ * with code kept in memory until the end and with streaming
+ */
+
+#include "bench.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../gen.h"
+#include "../parser.h"
+#include "../scanner.h"
+
+/**
+ * @brief Resident set size of current process in kB (Linux only, 0 elsewhere)
+ */
+static long current_rss(void) {
+    long pages = 0, resident = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (file != NULL) {
+        if (fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(file);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Compile program and write generated code to /dev/null (run in own process, so peak
+ * memory of every size is measured separately)
+ */
+static void compile(bench_buf_t* program, size_t statements, bool streaming) {
+    int out = dup(STDOUT_FILENO);
+    if (out < 0 || freopen("/dev/null", "w", stdout) == NULL) {
+        exit(99);
+    }
+    long start_rss = current_rss();
+
+    double start = bench_now();
+    scanner_t scanner = scanner_new_from_buffer(program->val, program->len);
+    gen_t gen = streaming ? gen_new_streaming(stdout) : gen_new();
+    parser_t parser = parser_new(&scanner, &gen);
+    parser_run(&parser);
+    // Only the part kept in memory (everything without streaming)
+    size_t output = (gen.header.len + gen.global.len) * sizeof(ir_instr_t) + gen.global_text.len +
+                    gen.functions_text.len;
+    gen_emit(&gen);
+    double time = bench_now() - start;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fflush(stdout);
+    dup2(out, STDOUT_FILENO);
+
+    char name[64];
+    snprintf(name, sizeof(name), "%zu functions%s", statements / 8,
+             streaming ? " (streaming)" : "");
+    bench_report(name, program->len, time);
+    printf("%-40s %10.1f MB kept until end, %.1f MB peak memory\n", "", output / 1e6,
+           (usage.ru_maxrss - start_rss) / 1e3);
+    fflush(stdout);
+}
+
+int main() {
+    const size_t sizes[] = {10000, 100000, 400000};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_buf_t program = bench_program(sizes[i]);
+        for (int streaming = 0; streaming <= 1; streaming++) {
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid < 0) {
+                return 99;
+            }
+            if (pid == 0) {
+                compile(&program, sizes[i], streaming);
+                _exit(0);
+            }
+            int status;
+            if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                return 1;
+            }
+        }
+        free(program.val);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_keywords.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Keyword recognition benchmark (strcmp chain vs generated perfect hash)
+ */
+
+#include "bench.h"
+#include "../keywords.h"
+#include "../scanner.h"
+
+#define IDENTIFIERS 4000000
+#define ROUNDS 3
+
+/**
+ * @brief Previous implementation of keyword recognition (kept for comparison)
+ */
+int keyword_chain(const char* str) {
+    if (strcmp("else", str) == 0)
+        return TOK_ELSE;
+    if (strcmp("float", str) == 0)
+        return TOK_FLOAT;
+    if (strcmp("function", str) == 0)
+        return TOK_FUNCTION;
+    if (strcmp("if", str) == 0)
+        return TOK_IF;
+    if (strcmp("int", str) == 0)
+        return TOK_INT;
+    if (strcmp("null", str) == 0)
+        return TOK_NULL;
+    if (strcmp("return", str) == 0)
+        return TOK_RETURN;
+    if (strcmp("string", str) == 0)
+        return TOK_STRING;
+    if (strcmp("void", str) == 0)
+        return TOK_VOID;
+    if (strcmp("while", str) == 0)
+        return TOK_WHILE;
+    if (strcmp("for", str) == 0)
+        return TOK_FOR;
+    if (strcmp("break", str) == 0)
+        return TOK_BREAK;
+    if (strcmp("continue", str) == 0)
+        return TOK_CONTINUE;
+    return -1;
+}
+
+int main() {
+    // Identifier-dense input: mostly function names, some keywords
+    const char* words[] = {"write",     "readi",   "substring", "strlen", "my_function",
+                           "calculate", "if",      "while",     "return", "floatval",
+                           "intval",    "strval",  "ord",       "chr",    "continue",
+                           "function",  "helper2", "else",      "int",    "process_data"};
+    const size_t word_count = sizeof(words) / sizeof(words[0]);
+    size_t lens[sizeof(words) / sizeof(words[0])];
+    for (size_t i = 0; i < word_count; i++) {
+        lens[i] = strlen(words[i]);
+    }
+
+    // Same words as a program for the whole scanner
+    bench_buf_t program = {0};
+    bench_printf(&program, "<?php\n");
+    for (size_t i = 0; i < IDENTIFIERS / 8; i++) {
+        bench_printf(&program, "%s ", words[i % word_count]);
+    }
+
+    for (int round = 0; round < ROUNDS; round++) {
+        long checksum = 0;
+        double start = bench_now();
+        for (size_t i = 0; i < IDENTIFIERS; i++) {
+            checksum += keyword_chain(words[i % word_count]);
+        }
+        double chain = bench_now() - start;
+
+        start = bench_now();
+        for (size_t i = 0; i < IDENTIFIERS; i++) {
+            checksum -= keyword_lookup(words[i % word_count], lens[i % word_count]);
+        }
+        double hash = bench_now() - start;
+
+        printf("strcmp chain   %8.3f ms  %6.1f ns/identifier\n", chain * 1e3,
+               chain / IDENTIFIERS * 1e9);
+        printf("perfect hash   %8.3f ms  %6.1f ns/identifier\n", hash * 1e3,
+               hash / IDENTIFIERS * 1e9);
+
+        start = bench_now();
+        scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+        while (true) {
+            token_t token = scanner_get_next(&scanner);
+            if (token.type == TOK_EOF) {
+                break;
+            }
+        }
+        scanner_free(&scanner);
+        bench_report("full lex of identifier-dense input", program.len, bench_now() - start);
+        printf("(checksum %ld)\n\n", checksum);
+    }
+
+    free(program.val);
+    return 0;
+}
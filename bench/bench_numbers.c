@@ -0,0 +1,120 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_numbers.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Numeric literal conversion benchmark (str_t + strtoul/strtod vs number engine)
+ */
+
+#include "bench.h"
+#include <ctype.h>
+#include "../number.h"
+#include "../scanner.h"
+#include "../str.h"
+
+#define LITERALS 2000000
+#define ROUNDS 3
+
+/**
+ * @brief Previous implementation: copy characters to the buffer and call strtoul / strtod
+ */
+double convert_strtod(const char* p, const char** end, str_t* buffer) {
+    bool is_float = false;
+    while (isdigit(*p) || *p == '.' || *p == 'e' || *p == '-') {
+        is_float |= !isdigit(*p);
+        str_add_char(buffer, *p++);
+    }
+    *end = p;
+    const char* text = str_val(buffer);
+    double value = is_float ? strtod(text, NULL) : (int)strtoul(text, NULL, 10);
+    str_clear(buffer);
+    return value;
+}
+
+/**
+ * @brief New implementation: value is accumulated digit by digit
+ */
+double convert_number(const char* p, const char** end) {
+    const char* start = p;
+    number_t number = number_new();
+    while (isdigit(*p)) {
+        number_add_digit(&number, *p++);
+    }
+    bool is_float = false;
+    if (*p == '.') {
+        is_float = true;
+        for (p++; isdigit(*p); p++) {
+            number_add_fraction_digit(&number, *p);
+        }
+    }
+    if (*p == 'e') {
+        is_float = true;
+        number.exp_negative = *++p == '-';
+        for (p += number.exp_negative; isdigit(*p); p++) {
+            number_add_exponent_digit(&number, *p);
+        }
+    }
+    *end = p;
+    int64_t value;
+    if (!is_float && number_to_int(&number, &value)) {
+        return value;
+    }
+    return number_to_double(&number, start, p - start);
+}
+
+int main() {
+    // Mix of integers, short decimals and floats with exponents
+    bench_buf_t program = {0};
+    bench_printf(&program, "<?php\n");
+    for (size_t i = 0; i < LITERALS; i++) {
+        switch (i % 4) {
+            case 0:
+                bench_printf(&program, "%zu ", i);
+                break;
+            case 1:
+                bench_printf(&program, "%zu.%zu ", i % 1000, i % 97);
+                break;
+            case 2:
+                bench_printf(&program, "%.17ge-%zu ", (double)i / 7, i % 300);
+                break;
+            case 3:
+                bench_printf(&program, "%.6e ", (double)i * 1.5);
+                break;
+        }
+    }
+
+    for (int round = 0; round < ROUNDS; round++) {
+        double checksum = 0;
+        str_t buffer = str_new();
+        const char* p = program.val + 6;
+        double start = bench_now();
+        while (*p != '\0') {
+            checksum += convert_strtod(p, &p, &buffer);
+            p++;
+        }
+        bench_report("str_t + strtoul/strtod", program.len, bench_now() - start);
+        str_free(&buffer);
+
+        p = program.val + 6;
+        start = bench_now();
+        while (*p != '\0') {
+            checksum -= convert_number(p, &p);
+            p++;
+        }
+        bench_report("number engine", program.len, bench_now() - start);
+
+        start = bench_now();
+        scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+        while (scanner_get_next(&scanner).type != TOK_EOF) {
+        }
+        scanner_free(&scanner);
+        bench_report("full lex of numeric literals", program.len, bench_now() - start);
+        printf("(checksum %g)\n\n", checksum);
+    }
+
+    free(program.val);
+    return 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_parallel.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Scaling of parallel speculative lexing over number of threads
+ */
+
+#include "bench.h"
+#include <unistd.h>
+#include "../scanner.h"
+#include "../scanner_parallel.h"
+
+#define STATEMENTS 400000
+#define ROUNDS 3
+
+int main() {
+    bench_buf_t program = bench_program(STATEMENTS);
+    // At least a few threads even on small machines (speedup is limited by number of cores)
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_threads = cores > 4 ? cores : 4;
+
+    printf("Input: %.1f MB, %ld cores\n", program.len / 1e6, cores);
+    for (int round = 0; round < ROUNDS; round++) {
+        double serial = 0;
+        for (unsigned threads = 1; threads <= max_threads; threads++) {
+            scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+            double start = bench_now();
+            size_t count;
+            token_t* tokens = scanner_lex_parallel(&scanner, threads, &count);
+            double time = bench_now() - start;
+            if (threads == 1) {
+                serial = time;
+            }
+
+            char name[64];
+            snprintf(name, sizeof(name), "%u threads (%.2fx)", threads, serial / time);
+            bench_report(name, program.len, time);
+            free(tokens);
+            scanner_free(&scanner);
+        }
+        printf("\n");
+    }
+
+    free(program.val);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_scanner.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Scanner throughput benchmark (stdio vs memory-resident source)
+ */
+
+#include "bench.h"
+#include "../scanner.h"
+#include "../token_queue.h"
+
+#define STATEMENTS 200000
+#define ROUNDS 3
+
+/**
+ * @brief Lex whole input and return number of tokens
+ */
+size_t lex_all(scanner_t* scanner) {
+    size_t count = 0;
+    while (true) {
+        token_t token = scanner_get_next(scanner);
+        count++;
+        if (token.type == TOK_EOF) {
+            break;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Lex whole input through token queue (batched refills) and return number of tokens
+ */
+size_t lex_all_queue(scanner_t* scanner) {
+    token_queue_t queue = token_queue_new(scanner);
+    size_t count = 0;
+    while (true) {
+        token_t token = token_queue_advance(&queue);
+        count++;
+        if (token.type == TOK_EOF) {
+            break;
+        }
+    }
+    token_queue_free(&queue);
+    return count;
+}
+
+int main() {
+    bench_buf_t program = bench_program(STATEMENTS);
+    FILE* file = tmpfile();
+    fwrite(program.val, 1, program.len, file);
+    rewind(file);
+
+    printf("Input: %.1f MB\n", program.len / 1e6);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        // Per-character stdio reading with one ungetc per token-ish (old input path)
+        rewind(file);
+        double start = bench_now();
+        size_t sum = 0;
+        int c;
+        while ((c = fgetc(file)) != EOF) {
+            if (c == ';') {
+                ungetc(c, file);
+                fgetc(file);
+            }
+            sum += c;
+        }
+        bench_report("fgetc/ungetc byte walk (stdio floor)", program.len, bench_now() - start);
+
+        // Full lexing through scanner_new(FILE*) (mmap)
+        rewind(file);
+        start = bench_now();
+        scanner_t scanner = scanner_new(file);
+        size_t tokens = lex_all(&scanner);
+        scanner_free(&scanner);
+        bench_report("scanner_new(FILE*) full lex", program.len, bench_now() - start);
+
+        // Full lexing over in-memory buffer
+        start = bench_now();
+        scanner = scanner_new_from_buffer(program.val, program.len);
+        lex_all(&scanner);
+        scanner_free(&scanner);
+        bench_report("scanner_new_from_buffer full lex", program.len, bench_now() - start);
+
+        // Full lexing over in-memory buffer through token queue
+        start = bench_now();
+        scanner = scanner_new_from_buffer(program.val, program.len);
+        lex_all_queue(&scanner);
+        scanner_free(&scanner);
+        bench_report("token queue full lex", program.len, bench_now() - start);
+
+        printf("(%zu tokens, checksum %zu)\n\n", tokens, sum);
+    }
+
+    fclose(file);
+    free(program.val);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_skip.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Fast-skip kernel benchmark on comment-heavy and string-heavy inputs
+ */
+
+#include "bench.h"
+#include "../scanner.h"
+#include "../skip.h"
+
+#define LINES 200000
+#define ROUNDS 3
+
+/**
+ * @brief Program consisting mostly of comments and indentation
+ */
+bench_buf_t comment_corpus() {
+    bench_buf_t buf = {0};
+    bench_printf(&buf, "<?php\ndeclare(strict_types=1);\n");
+    for (size_t i = 0; i < LINES; i++) {
+        if (i % 4 == 0) {
+            bench_printf(&buf, "/* Block comment number %zu that spans\n", i);
+            bench_printf(&buf, "        a couple of lines and talks about nothing at all */\n");
+        } else {
+            bench_printf(&buf, "                // Line comment %zu describing the next statement\n",
+                         i);
+            bench_printf(&buf, "                $a = $a + 1;\n");
+        }
+    }
+    return buf;
+}
+
+/**
+ * @brief Program consisting mostly of long string literals
+ */
+bench_buf_t string_corpus() {
+    bench_buf_t buf = {0};
+    bench_printf(&buf, "<?php\ndeclare(strict_types=1);\n");
+    for (size_t i = 0; i < LINES; i++) {
+        bench_printf(&buf,
+                     "$s = \"Lorem ipsum dolor sit amet, consectetur adipiscing elit %zu, sed do "
+                     "eiusmod tempor incididunt ut labore et dolore magna aliqua\\n\";\n",
+                     i);
+    }
+    return buf;
+}
+
+/**
+ * @brief Lex whole buffer and return number of tokens
+ */
+size_t lex_all(bench_buf_t* program) {
+    scanner_t scanner = scanner_new_from_buffer(program->val, program->len);
+    size_t count = 0;
+    while (true) {
+        token_t token = scanner_get_next(&scanner);
+        count++;
+        if (token.type == TOK_EOF) {
+            break;
+        }
+    }
+    scanner_free(&scanner);
+    return count;
+}
+
+/**
+ * @brief Run kernel repeatedly over the whole buffer (restarting after every stop)
+ */
+size_t run_kernel(bench_buf_t* program, const char* (*kernel)(const char*, const char*)) {
+    const char* p = program->val;
+    const char* end = program->val + program->len;
+    size_t stops = 0;
+    while (p < end) {
+        p = kernel(p, end) + 1;
+        stops++;
+    }
+    return stops;
+}
+
+int main() {
+    const char* impl_names[] = {"scalar", "sse2", "avx2"};
+    bench_buf_t corpora[] = {comment_corpus(), string_corpus()};
+    const char* corpus_names[] = {"comments", "strings"};
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int c = 0; c < 2; c++) {
+            printf("Corpus: %s (%.1f MB)\n", corpus_names[c], corpora[c].len / 1e6);
+            for (skip_impl_t impl = SKIP_IMPL_SCALAR; impl <= SKIP_IMPL_AVX2; impl++) {
+                if (!skip_use(impl)) {
+                    printf("%-40s unsupported\n", impl_names[impl]);
+                    continue;
+                }
+                char name[64];
+
+                double start = bench_now();
+                run_kernel(&corpora[c], c == 0 ? skip_to_newline : skip_string_body);
+                snprintf(name, sizeof(name), "%s kernel only", impl_names[impl]);
+                bench_report(name, corpora[c].len, bench_now() - start);
+
+                start = bench_now();
+                lex_all(&corpora[c]);
+                snprintf(name, sizeof(name), "%s full lex", impl_names[impl]);
+                bench_report(name, corpora[c].len, bench_now() - start);
+            }
+            printf("\n");
+        }
+    }
+
+    free(corpora[0].val);
+    free(corpora[1].val);
+    return 0;
+}
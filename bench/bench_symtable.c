@@ -0,0 +1,76 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_symtable.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Inserts and lookups in symbol table with 10, 1k and 100k symbols
+ */
+
+#include "bench.h"
+#include "../symtable.h"
+
+// Number of operations of each kind per table size
+#define OPERATIONS 10000000
+
+int main() {
+    const size_t sizes[] = {10, 1000, 100000};
+
+    for (int s = 0; s < 3; s++) {
+        size_t count = sizes[s];
+        size_t rounds = OPERATIONS / count;
+
+        // Names are interned by the scanner, so it isn't measured
+        token_t* tokens = malloc(count * sizeof(token_t));
+        size_t* order = malloc(count * sizeof(size_t));
+        if (tokens == NULL || order == NULL) {
+            return 1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            char name[32];
+            int len = snprintf(name, sizeof(name), "global_variable_%zu", i);
+            tokens[i] = token_new_with_string(TOK_VAR, name, len, 0);
+            order[i] = i;
+        }
+        // Lookups come in random order
+        srand(42);
+        for (size_t i = count - 1; i > 0; i--) {
+            size_t j = rand() % (i + 1);
+            size_t tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+
+        double insert = 0, lookup = 0;
+        size_t found = 0;
+        for (size_t r = 0; r < rounds; r++) {
+            arena_t* arena = arena_new();
+            htab_t* table = htab_new(arena);
+
+            double start = bench_now();
+            for (size_t i = 0; i < count; i++) {
+                htab_add_variable(table, &tokens[i]);
+            }
+            insert += bench_now() - start;
+
+            start = bench_now();
+            for (size_t i = 0; i < count; i++) {
+                // Existing variable is only looked up
+                found += !htab_add_variable(table, &tokens[order[i]]);
+            }
+            lookup += bench_now() - start;
+
+            htab_free(table);
+            arena_free(arena);
+        }
+
+        size_t operations = rounds * count;
+        printf("%6zu symbols   insert %6.1f ns   lookup %6.1f ns   (found %zu)\n", count,
+               insert / operations * 1e9, lookup / operations * 1e9, found);
+        free(tokens);
+        free(order);
+    }
+    return 0;
+}
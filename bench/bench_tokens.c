@@ -0,0 +1,67 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file bench_tokens.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Memory per million tokens when the whole program is lexed into one array
+ */
+
+#include "bench.h"
+#include <unistd.h>
+#include "../intern.h"
+#include "../scanner.h"
+#include "../scanner_parallel.h"
+
+#define STATEMENTS 200000
+
+/**
+ * @brief Resident set size of current process in kB (Linux only, 0 elsewhere)
+ */
+static long current_rss(void) {
+    long pages = 0, resident = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (file != NULL) {
+        if (fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(file);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+int main() {
+    bench_buf_t program = bench_program(STATEMENTS);
+    // Touch the input, so it isn't counted
+    size_t checksum = 0;
+    for (size_t i = 0; i < program.len; i += 4096) {
+        checksum += program.val[i];
+    }
+    long start_rss = current_rss();
+
+    double start = bench_now();
+    scanner_t scanner = scanner_new_from_buffer(program.val, program.len);
+    size_t count;
+    token_t* tokens = scanner_lex_parallel(&scanner, 1, &count);
+    double time = bench_now() - start;
+    long rss = current_rss() - start_rss;
+
+    const double millions = count / 1e6;
+    char name[64];
+    snprintf(name, sizeof(name), "%.2fM tokens", millions);
+    bench_report(name, program.len, time);
+    printf("%-40s %10zu bytes\n", "  sizeof(token_t)", sizeof(token_t));
+    printf("%-40s %10.1f MB\n", "  token array per 1M tokens",
+           sizeof(token_t) * count / millions / 1e6);
+    printf("%-40s %10.1f MB\n", "  memory growth per 1M tokens", rss / millions / 1e3);
+    intern_print_stats(stdout);
+    printf("(checksum %zu)\n", checksum);
+
+    free(tokens);
+    scanner_free(&scanner);
+    intern_free();
+    free(program.val);
+    return 0;
+}
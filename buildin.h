@@ -117,6 +117,10 @@ void gen_func_intval(gen_t* gen);
  */
 void gen_func_strval(gen_t* gen);
 
+// Helpers for expressions (labels starting with !) don't create frames, they only use the
+// GF@?tmp1-4 and GF@?type1-2 variables and the data stack, so they can be called from anywhere
+// without changing frames of the caller.
+
 /**
  * @brief Prepare parameters for arithmetic functions (+, -, *)
  * If either of the parameters is null, they are replaced with 0
@@ -138,6 +142,15 @@ void gen_num_prepare(gen_t* gen);
  */
 void gen_num_prepare_div(gen_t* gen);
 
+/**
+ * @brief Slow paths of inline arithmetic (!arith_add, !arith_sub, !arith_mul)
+ * Operands are in GF@?tmp1 and GF@?tmp2, they are prepared by !num_prepare
+ * and the result is pushed to stack
+ *
+ * @param gen Generator instance
+ */
+void gen_arith_slow(gen_t* gen);
+
 /**
  * @brief Concat two strings
  * Parameters are on top of stack
@@ -163,13 +176,6 @@ void gen_to_bool(gen_t* gen);
  */
 void gen_equals(gen_t* gen);
 
-/**
- * @brief Convert ints to floats
- *
- * @param gen Generator instance
- */
-void gen_comp_prepare(gen_t* gen);
-
 /**
  * @brief Evaluate > operator
  * Parameters are GF@?tmp1 and GF@?tmp2
@@ -26,7 +26,7 @@ const char* error_msgs[] = {
     [ERR_SEM] = "Other semantic error",
     [ERR_INTERNAL] = "Internal error (e.g. memory allocation error)"};
 
-void error_exit(enum return_code code) {
+_Noreturn void error_exit(enum return_code code) {
     fprintf(stderr, "%s\n", error_msgs[code]);
     exit(code);
 }
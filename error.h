@@ -31,7 +31,7 @@ enum return_code {
  *
  * @param code Error code
  */
-void error_exit(enum return_code code);
+_Noreturn void error_exit(enum return_code code);
 
 /**
  * @brief Used when something is not implemented yet
@@ -13,9 +13,9 @@
 #include <stdio.h>
 #include "error.h"
 #include "parser.h"
+#include "postfix.h"
 #include "stack.h"
 #include "token.h"
-#include "token_term.h"
 
 #define TABLE_SIZE 19
 
@@ -29,96 +29,36 @@ enum {
 /**
  * @brief Parses parenthesis
  *
- * @param stack instance of stack containing the expression
- * @return token_term_t result of the expression
+ * @param handle Items of the handle (3)
+ * @return Token of the inner nonterminal
  */
-token_term_t* parse_paren(stack_t* stack) {
-    if (!(type_is_literal(stack->tokens[1]->result) || stack->tokens[1]->result == TOK_VAR)) {
+token_t parse_paren(stack_item_t* handle) {
+    if (handle[1].terminal) {
         error_exit(ERR_SYN);
     }
 
-    if (stack->tokens[1]->terminal) {
+    if (!handle[2].terminal || handle[2].token.type != TOK_RPAREN) {
         error_exit(ERR_SYN);
     }
 
-    if (stack->tokens[0]->value.type != TOK_RPAREN || stack->tokens[2]->result != TOK_LPAREN) {
-        error_exit(ERR_SYN);
-    }
-
-    token_term_free(stack->tokens[0]);
-    token_term_free(stack->tokens[2]);
-    return stack->tokens[1];
-}
-
-/**
- * @brief Parses arithmetic expression
- *
- * @param stack instance of stack containing the expression
- * @return token_term_t result of the expression
- */
-token_term_t* parse_arithmetic(stack_t* stack) {
-    token_term_t* new = stack->tokens[1];
-    new->terminal = false;
-    new->right = stack->tokens[0];
-    new->left = stack->tokens[2];
-    new->result = TOK_VAR;
-
-    if (!(type_is_literal(stack->tokens[0]->result) || stack->tokens[0]->result == TOK_VAR)) {
-        error_exit(ERR_SYN);
-    }
-    if (!(type_is_literal(stack->tokens[2]->result) || stack->tokens[2]->result == TOK_VAR)) {
-        error_exit(ERR_SYN);
-    }
-    if (stack->tokens[0]->terminal || stack->tokens[2]->terminal) {
-        error_exit(ERR_SYN);
-    }
-
-    return new;
-}
-
-/**
- * @brief Parses string concatenation
- *
- * @param stack instance of stack containing the expression
- * @return token_term_t result of the expression
- */
-token_term_t* parse_concat(stack_t* stack) {
-    token_term_t* new = stack->tokens[1];
-    new->terminal = false;
-    new->right = stack->tokens[0];
-    new->left = stack->tokens[2];
-    new->result = TOK_STR_LIT;
-
-    if (stack->tokens[0]->terminal || stack->tokens[2]->terminal) {
-        error_exit(ERR_SYN);
-    }
-    return new;
+    // Nothing is appended, postfix notation doesn't need parentheses
+    return handle[1].token;
 }
 
 /**
- * @brief Parses comparison
+ * @brief Parses binary operation (both operands have to be nonterminals)
  *
- * @param stack instance of stack containing the expression
- * @return token_term_t result of the expression
+ * @param postfix Postfix expression (operands are already in it)
+ * @param handle Items of the handle (3)
+ * @return Token of the operator
  */
-token_term_t* parse_comparison(stack_t* stack) {
-    token_term_t* new = stack->tokens[1];
-    new->terminal = false;
-    new->right = stack->tokens[0];
-    new->left = stack->tokens[2];
-    new->result = TOK_BOOL_LIT;
-
-    if (!(type_is_literal(stack->tokens[0]->result) || stack->tokens[0]->result == TOK_VAR)) {
-        error_exit(ERR_SYN);
-    }
-    if (!(type_is_literal(stack->tokens[2]->result) || stack->tokens[2]->result == TOK_VAR)) {
-        error_exit(ERR_SYN);
-    }
-    if (stack->tokens[0]->terminal || stack->tokens[2]->terminal) {
+token_t parse_binary(postfix_t* postfix, stack_item_t* handle) {
+    if (handle[0].terminal || handle[2].terminal) {
         error_exit(ERR_SYN);
     }
 
-    return new;
+    postfix_add(postfix, handle[1].token);
+    return handle[1].token;
 }
 
 const int precedence_table[TABLE_SIZE][TABLE_SIZE] = {
@@ -153,93 +93,76 @@ int get_precedence(token_t stack_top, token_t input) {
     return precedence_table[stack_top.type][input.type];
 }
 
-token_term_t* parse_expression(stack_t* stack) {
-    if (stack->len == 3) {
-        int type = stack->tokens[1]->value.type;
-        if (stack->tokens[2]->value.type == TOK_LPAREN) {
-            return parse_paren(stack);
+token_t parse_expression(stack_t* stack, int start, postfix_t* postfix) {
+    stack_item_t* handle = &stack->items[start];
+    const int len = stack->len - start;
+    if (len == 3) {
+        if (handle[0].terminal && handle[0].token.type == TOK_LPAREN) {
+            return parse_paren(handle);
         }
-        switch (type) {
+        if (!handle[1].terminal) {
+            error_exit(ERR_SYN);
+        }
+        switch (handle[1].token.type) {
             case TOK_PLUS:
             case TOK_MINUS:
             case TOK_MULTIPLY:
             case TOK_DIVIDE:
-                return parse_arithmetic(stack);
-                break;
-
             case TOK_LESS:
             case TOK_LESS_E:
             case TOK_GREATER:
             case TOK_GREATER_E:
             case TOK_EQUALS:
             case TOK_NEQUALS:
-                return parse_comparison(stack);
-                break;
-
             case TOK_DOT:
-                return parse_concat(stack);
-                break;
+                return parse_binary(postfix, handle);
 
             default:
-
                 error_exit(ERR_SYN);
                 break;
         }
-    } else if (stack->len == 1) {  // Rules for single identifier/single non terminal
-        if (token_is_literal(&stack->tokens[0]->value) || stack->tokens[0]->value.type == TOK_VAR) {
-            if (stack->tokens[0]->terminal) {
-                stack->tokens[0]->terminal = false;
-                return stack->tokens[0];
-            } else {
-                error_not_implemented();
-                if (token_is_literal(&stack->tokens[0]->value) ||
-                    stack->tokens[0]->value.type == TOK_VAR) {
-                    return token_term_new(token_new(TOK_EXP_END, 0, 0), false);
-                }
+    } else if (len == 1) {  // Rules for single identifier/single non terminal
+        if (handle[0].terminal) {
+            if (token_is_literal(&handle[0].token) || handle[0].token.type == TOK_VAR) {
+                postfix_add(postfix, handle[0].token);
+                return handle[0].token;
             }
+        } else if (token_is_literal(&handle[0].token) || handle[0].token.type == TOK_VAR) {
+            error_not_implemented();
         }
     }
 
     error_exit(ERR_SYN);
-    return NULL;
+    return handle[0].token;
 }
 
 void rule_exp(parser_t* parser, parser_state_t state) {
     (void)state;
-    stack_t stack = stack_new();
-    stack_t current_expression = stack_new();
+    stack_t stack = stack_new(parser->exp_arena);
+    postfix_t postfix = postfix_new(parser->exp_arena);
 
-    stack_push(&stack, token_term_new(token_new(TOK_DOLLAR, 0, 0), true));
+    stack_shift(&stack, token_new(TOK_DOLLAR, 0), false);
 
     while (true) {
-        int precedence = get_precedence(stack_top_terminal(&stack)->value, parser->token);
-
-        token_term_t* token = NULL;
+        int precedence = get_precedence(*stack_top_terminal(&stack), parser->token);
 
         if (!stack_top(&stack)->terminal && stack.len == 2 &&
             (precedence == R || precedence == X)) {
-            gen_exp(parser->gen, stack_top(&stack), state.in_function);
+            gen_exp(parser->gen, &postfix, state.in_function);
             break;
         }
         switch (precedence) {
             case L:
-                stack_push_after_terminal(&stack);
-                stack_push(&stack, token_term_new(parser->token, true));
+                stack_shift(&stack, parser->token, true);
                 next_token_keep(parser);
                 break;
-            case R:
-                while ((token = stack_pop(&stack))->value.type != TOK_HANDLE_START) {
-                    if (token->value.type != TOK_HANDLE_START) {
-                        stack_push(&current_expression, token);
-                    } else {
-                        token_term_free(token);
-                    }
-                }
-                token_term_free(token);
-                stack_push(&stack, parse_expression(&current_expression));
+            case R: {
+                int start = stack_handle(&stack);
+                stack_reduce(&stack, start, parse_expression(&stack, start, &postfix));
                 break;
+            }
             case E:
-                stack_push(&stack, token_term_new(parser->token, true));
+                stack_shift(&stack, parser->token, false);
                 next_token_keep(parser);
                 break;
             case X:
@@ -248,9 +171,9 @@ void rule_exp(parser_t* parser, parser_state_t state) {
             default:
                 break;
         }
-        stack_empty(&current_expression);
     }
-    stack_free(&current_expression);
     stack_free(&stack);
+    // Whole expression is released at once
+    arena_reset(parser->exp_arena);
     return;
 }
@@ -13,8 +13,8 @@
 #define __EXP_H__
 
 #include "parser.h"
+#include "postfix.h"
 #include "stack.h"
-#include "token_term.h"
 
 /**
  * @brief Implements expression parsing
@@ -14,32 +14,114 @@
 #include <string.h>
 #include "buildin.h"
 #include "error.h"
+#include "intern.h"
+
+// Global code is printed (and streamed) in blocks of at least this number of instructions
+#define GEN_STREAM_BLOCK 4096
+
+// Operands used all over the generated code
+#define TMP1 ir_var(IR_GF, "?tmp1")
+#define TMP2 ir_var(IR_GF, "?tmp2")
+#define TYPE1 ir_var(IR_GF, "?type1")
+#define TYPE2 ir_var(IR_GF, "?type2")
 
 gen_t gen_new() {
     gen_t gen = {
-        .header = str_new(),
-        .global = str_new(),
-        .functions = str_new(),
-        .function_header = str_new(),
-        .function = str_new(),
-        .function_name = str_new(),
-        .params = str_new(),
+        .header = ir_code_new(),
+        .global = ir_code_new(),
+        .functions = ir_code_new(),
+        .global_text = rope_new(),
+        .functions_text = rope_new(),
+        .function_header = ir_code_new(),
+        .function = ir_code_new(),
+        .function_name = str_new_view("", 0),
+        .write_name = intern_cstr("write"),
+        .params = ir_code_new(),
         .variable = str_new(),
         .param_count = 0,
+        .stream = NULL,
+        .stream_count = 0,
+        .arith_count = 0,
+        .infer = infer_new(),
+        .exp_type = INFER_UNKNOWN,
     };
     return gen;
 }
 
+gen_t gen_new_streaming(FILE* stream) {
+    gen_t gen = gen_new();
+    gen.stream = stream;
+    return gen;
+}
+
+/**
+ * @brief Print finished code to its text and clear it (text is written right away when streaming)
+ *
+ * @param gen Generator instance
+ * @param code Finished code
+ * @param text Text of the code
+ */
+static void gen_flush(gen_t* gen, ir_code_t* code, rope_t* text) {
+    ir_code_print(code, text);
+    ir_code_clear(code);
+    if (gen->stream != NULL) {
+        rope_write(text, gen->stream);
+        rope_clear(text);
+    }
+}
+
+/**
+ * @brief Print global code when a block is big enough (it is only appended, so any prefix is final)
+ *
+ * @param gen Generator instance
+ */
+static void gen_flush_global(gen_t* gen) {
+    if (gen->global.len >= GEN_STREAM_BLOCK) {
+        gen_flush(gen, &gen->global, &gen->global_text);
+    }
+}
+
+/**
+ * @brief Operand of variable in current scope
+ *
+ * @param name Interned name of variable
+ * @param in_function Whether are we in function scope
+ */
+static ir_operand_t gen_var(const char* name, bool in_function) {
+    return ir_var(in_function ? IR_LF : IR_GF, name);
+}
+
+/**
+ * @brief Interned name of variable which marks function as declared (?name$declared)
+ *
+ * @param name Function name
+ */
+static const char* gen_declared_name(const char* name) {
+    str_t str = str_new();
+    str_add_char(&str, '?');
+    str_add_cstr(&str, name);
+    str_add_cstr(&str, "$declared");
+    const char* interned = intern(str_val(&str), str_len(&str));
+    str_free(&str);
+    return interned;
+}
+
 void gen_header(gen_t* gen) {
-    // Program header
-    str_add_cstr(&gen->header, ".IFJcode22\n");
+    // Program header (streamed code starts with jump to the header, which is emitted at the end)
+    if (gen->stream != NULL) {
+        ir_add(&gen->functions, IR_HEADER);
+        ir_add1(&gen->functions, IR_JUMP, ir_label("!?header", -1));
+    } else {
+        ir_add(&gen->header, IR_HEADER);
+    }
     // Temporary variables for operations
-    str_add_cstr(&gen->header, "DEFVAR GF@?tmp1\n");
-    str_add_cstr(&gen->header, "DEFVAR GF@?tmp2\n");
-    str_add_cstr(&gen->header, "DEFVAR GF@?tmp3\n");
-    str_add_cstr(&gen->header, "DEFVAR GF@?tmp4\n");
-    str_add_cstr(&gen->header, "DEFVAR GF@?type1\n");
-    str_add_cstr(&gen->header, "DEFVAR GF@?type2\n");
+    ir_add_asm(&gen->header,
+               "DEFVAR GF@?tmp1\n"
+               "DEFVAR GF@?tmp2\n"
+               "DEFVAR GF@?tmp3\n"
+               "DEFVAR GF@?tmp4\n"
+               "DEFVAR GF@?type1\n"
+               "DEFVAR GF@?type2\n");
     // Generate buidin functions
     gen_func_write(gen);
     gen_func_readi(gen);
@@ -55,12 +137,17 @@ void gen_header(gen_t* gen) {
     // Generate helper functions
     gen_num_prepare(gen);
     gen_num_prepare_div(gen);
+    gen_arith_slow(gen);
     gen_concat(gen);
     gen_to_bool(gen);
     gen_equals(gen);
-    gen_comp_prepare(gen);
     gen_greater(gen);
     gen_greater_equals(gen);
+    // Buildin functions are only called, global code follows them
+    if (gen->stream != NULL) {
+        ir_add1(&gen->functions, IR_LABEL, ir_label("!?global", -1));
+    }
+    gen_flush(gen, &gen->functions, &gen->functions_text);
     // Set current scope
     gen->current = &gen->global;
     gen->current_header = &gen->header;
@@ -68,184 +155,137 @@ void gen_header(gen_t* gen) {
 
 void gen_footer(gen_t* gen) {
     // Global exit (success)
-    str_add_cstr(&gen->global, "EXIT int@0\n");
+    ir_add1(&gen->global, IR_EXIT, ir_int(0));
     // Error exits
-    str_add_cstr(&gen->global,
-                 "LABEL !ERR_CALL\n"
-                 "EXIT int@3\n"
-                 "LABEL !ERR_SEM_CALL\n"
-                 "EXIT int@4\n"
-                 "LABEL !ERR_SEM_VAR\n"
-                 "EXIT int@5\n"
-                 "LABEL !ERR_SEM_RET\n"
-                 "EXIT int@6\n"
-                 "LABEL !ERR_SEM_COMP\n"
-                 "EXIT int@7\n");
+    ir_add_asm(&gen->global,
+               "LABEL !ERR_CALL\n"
+               "EXIT int@3\n"
+               "LABEL !ERR_SEM_CALL\n"
+               "EXIT int@4\n"
+               "LABEL !ERR_SEM_VAR\n"
+               "EXIT int@5\n"
+               "LABEL !ERR_SEM_RET\n"
+               "EXIT int@6\n"
+               "LABEL !ERR_SEM_COMP\n"
+               "EXIT int@7\n");
+}
+
+/**
+ * @brief Convert result of the last expression (?tmp1) to bool
+ *
+ * @param gen Generator instance
+ */
+static void gen_to_bool_call(gen_t* gen) {
+    // Comparisons are bool already
+    if (gen->exp_type != INFER_BOOL) {
+        ir_add1(gen->current, IR_CALL, ir_label("!to_bool", -1));
+    }
 }
 
 void gen_if(gen_t* gen, int construct_count) {
     // Jump to else branch if condition is not met
-    str_add_cstr(gen->current,
-                 "CALL !to_bool\n"
-                 "JUMPIFEQ !else_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, " GF@?tmp1 bool@false\n");
+    gen_to_bool_call(gen);
+    ir_add3(gen->current, IR_JUMPIFEQ, ir_label("!else_", construct_count), TMP1, ir_bool(false));
+    infer_if(&gen->infer);
 }
 
 void gen_else(gen_t* gen, int construct_count) {
     // Jump to if-else end in if branch
-    str_add_cstr(gen->current, "JUMP !elseifend_");
-    str_add_int(gen->current, construct_count);
-    str_add_char(gen->current, '\n');
-    // Else branch label
-    str_add_cstr(gen->current, "LABEL !else_");
-    str_add_int(gen->current, construct_count);
-    str_add_char(gen->current, '\n');
+    ir_add1(gen->current, IR_JUMP, ir_label("!elseifend_", construct_count));
+    // Else branch label (variables have types from before the if branch)
+    ir_add1(gen->current, IR_LABEL, ir_label("!else_", construct_count));
+    infer_if_join(&gen->infer, false);
 }
 
 void gen_if_else_end(gen_t* gen, int construct_count) {
     // If-else end label
-    str_add_cstr(gen->current, "LABEL !elseifend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_LABEL, ir_label("!elseifend_", construct_count));
+    infer_if_join(&gen->infer, true);
 }
 
 void gen_loop(gen_t* gen, int construct_count) {
-    // While label
-    str_add_cstr(gen->current, "LABEL !loop_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    // While label (reached also from the end of the loop)
+    ir_add1(gen->current, IR_LABEL, ir_label("!loop_", construct_count));
+    infer_forget(&gen->infer);
 }
 
 void gen_loop_exit(gen_t* gen, int construct_count) {
     // Jump to while end if condition is not met
-    str_add_cstr(gen->current,
-                 "CALL !to_bool\n"
-                 "JUMPIFEQ !loopend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, " GF@?tmp1 bool@false\n");
+    gen_to_bool_call(gen);
+    ir_add3(gen->current, IR_JUMPIFEQ, ir_label("!loopend_", construct_count), TMP1,
+            ir_bool(false));
 }
 
 void gen_loop_end(gen_t* gen, int construct_count) {
     // Define modify label (for continue)
-    str_add_cstr(gen->current, "LABEL !loopmodify_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_LABEL, ir_label("!loopmodify_", construct_count));
     // Jump back to loop label
-    str_add_cstr(gen->current, "JUMP !loop_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loop_", construct_count));
     // Define while end label
-    str_add_cstr(gen->current, "LABEL !loopend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");   
+    ir_add1(gen->current, IR_LABEL, ir_label("!loopend_", construct_count));
+    infer_forget(&gen->infer);
 }
 
 void gen_for_end(gen_t* gen, int construct_count) {
     // Jump back to modify label
-    str_add_cstr(gen->current, "JUMP !loopmodify_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loopmodify_", construct_count));
     // Define while end label
-    str_add_cstr(gen->current, "LABEL !loopend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_LABEL, ir_label("!loopend_", construct_count));
+    infer_forget(&gen->infer);
 }
 
 void gen_for_modify_start(gen_t* gen, int construct_count) {
-    str_add_cstr(gen->current, "JUMP !loopmodifyend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current,
-                 "\n"
-                 "LABEL !loopmodify_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loopmodifyend_", construct_count));
+    ir_add1(gen->current, IR_LABEL, ir_label("!loopmodify_", construct_count));
+    infer_forget(&gen->infer);
 }
 
 void gen_for_modify_end(gen_t* gen, int construct_count) {
-    str_add_cstr(gen->current, "JUMP !loop_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current,
-                 "\n"
-                 "LABEL !loopmodifyend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loop_", construct_count));
+    ir_add1(gen->current, IR_LABEL, ir_label("!loopmodifyend_", construct_count));
+    infer_forget(&gen->infer);
 }
 
 void gen_break(gen_t* gen, int construct_count) {
-    str_add_cstr(gen->current, "JUMP !loopend_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loopend_", construct_count));
 }
 
 void gen_continue(gen_t* gen, int construct_count) {
-    str_add_cstr(gen->current, "JUMP !loopmodify_");
-    str_add_int(gen->current, construct_count);
-    str_add_cstr(gen->current, "\n");
+    ir_add1(gen->current, IR_JUMP, ir_label("!loopmodify_", construct_count));
 }
 
 /**
  * @brief Generate value (literal / variable) from token
  *
- * @param str Destination
+ * @param code Destination
  * @param token Source token
+ * @param type Inferred type of the value (variable without INFER_UNDEF isn't checked)
  * @param in_function Whether are we in function scope
  */
-void gen_value(str_t* str, token_t* token, bool in_function) {
+static void gen_value(ir_code_t* code, token_t* token, infer_type_t type, bool in_function) {
     switch (token->type) {
-        case TOK_INT_LIT: {
-            str_add_cstr(str, "PUSHS ");
-            str_add_cstr(str, "int@");
-            char buf[16];
-            sprintf(buf, "%d", token->attr.val_i);
-            str_add_cstr(str, buf);
+        case TOK_INT_LIT:
+            ir_add1(code, IR_PUSHS, ir_int(token->attr.val_i));
             break;
-        }
-        case TOK_FLOAT_LIT: {
-            str_add_cstr(str, "PUSHS ");
-            str_add_cstr(str, "float@");
-            char buf[32];
-            sprintf(buf, "%a", token->attr.val_f);
-            str_add_cstr(str, buf);
+        case TOK_FLOAT_LIT:
+            ir_add1(code, IR_PUSHS, ir_float(token->attr.val_f));
             break;
-        }
         case TOK_STR_LIT:
-            str_add_cstr(str, "PUSHS ");
-            str_add_cstr(str, "string@");
-            for (size_t i = 0; i < token->attr.val_s.len; i++) {
-                char c = token->attr.val_s.val[i];
-                // These ASCII codes have to be represented with escape sequences
-                if ((c >= 0 && c <= 32) || c == 35 || c == 92) {
-                    str_add_char(str, '\\');
-                    char buf[5];
-                    sprintf(buf, "%03d", c);
-                    str_add_cstr(str, buf);
-                } else {
-                    str_add_char(str, c);
-                }
-            }
+            ir_add1(code, IR_PUSHS, ir_string(token->attr.val_s, intern_len(token->attr.val_s)));
             break;
         case TOK_NULL:
-            str_add_cstr(str, "PUSHS ");
-            str_add_cstr(str, "nil@nil");
+            ir_add1(code, IR_PUSHS, ir_nil());
             break;
-        case TOK_VAR:
-            str_add_cstr(str, "TYPE GF@?type1 ");
-            if (in_function) {
-                str_add_cstr(str, "LF@");
-            } else {
-                str_add_cstr(str, "GF@");
-            }
-            str_add_str(str, &token->attr.val_s);
-            str_add_cstr(str, "\nJUMPIFEQ !ERR_SEM_VAR string@ GF@?type1\n");
-            str_add_cstr(str, "PUSHS ");
-            if (in_function) {
-                str_add_cstr(str, "LF@");
-            } else {
-                str_add_cstr(str, "GF@");
+        case TOK_VAR: {
+            // Undefined variable has empty type
+            ir_operand_t var = gen_var(token->attr.val_s, in_function);
+            if (type & INFER_UNDEF) {
+                ir_add2(code, IR_TYPE, TYPE1, var);
+                ir_add3(code, IR_JUMPIFEQ, ir_label("!ERR_SEM_VAR", -1), ir_string("", 0), TYPE1);
             }
-            str_add_str(str, &token->attr.val_s);
+            ir_add1(code, IR_PUSHS, var);
             break;
+        }
         default:
             // Other token types shouldn't be here
             error_exit(ERR_INTERNAL);
@@ -254,147 +294,141 @@ void gen_value(str_t* str, token_t* token, bool in_function) {
 
 void gen_function(gen_t* gen, token_t* token) {
     // Define variable for declaration check
-    str_add_cstr(&gen->header, "DEFVAR GF@?");
-    str_add_cstr(&gen->header, token->attr.val_s.val);
-    str_add_cstr(&gen->header, "$declared\n");
-    str_add_cstr(&gen->header, "MOVE GF@?");
-    str_add_cstr(&gen->header, token->attr.val_s.val);
-    str_add_cstr(&gen->header, "$declared bool@false\n");
+    ir_operand_t declared = ir_var(IR_GF, gen_declared_name(token->attr.val_s));
+    ir_add1(&gen->header, IR_DEFVAR, declared);
+    ir_add2(&gen->header, IR_MOVE, declared, ir_bool(false));
     // Mark function as declared
-    str_add_cstr(&gen->global, "MOVE GF@?");
-    str_add_cstr(&gen->global, token->attr.val_s.val);
-    str_add_cstr(&gen->global, "$declared bool@true\n");
+    ir_add2(&gen->global, IR_MOVE, declared, ir_bool(true));
     // Generate label for our function
-    str_add_cstr(&gen->function_header, "LABEL ");
-    str_add_cstr(&gen->function_header, token->attr.val_s.val);
-    str_add_cstr(&gen->function_header, "\n");
+    ir_add1(&gen->function_header, IR_LABEL, ir_label(token->attr.val_s, -1));
     // Create function frame and return value
-    str_add_cstr(&gen->function_header,
-                 "CREATEFRAME\n"
-                 "PUSHFRAME\n"
-                 "DEFVAR LF@?tmp1\n");
+    ir_add_asm(&gen->function_header,
+               "CREATEFRAME\n"
+               "PUSHFRAME\n"
+               "DEFVAR LF@?tmp1\n");
     // Set scope to function
     gen->current = &gen->function;
     gen->current_header = &gen->function_header;
 }
 
+void gen_function_body(gen_t* gen, htab_fun_t* function) {
+    // Parameters are type checked when they are popped
+    infer_function(&gen->infer, function);
+}
+
 void gen_function_end(gen_t* gen, htab_fun_t* function, char* function_name) {
+    ir_code_t* header = &gen->function_header;
+    // Labels of type checks are function name with parameter index (name!index)
+    str_t prefix = str_new();
+    str_add_cstr(&prefix, function_name);
+    str_add_char(&prefix, '!');
+    const char* label = intern(str_val(&prefix), str_len(&prefix));
+    str_free(&prefix);
+
     // Get values from stack to local variables
     for (int i = 0; i < function->param_count; i++) {
+        ir_operand_t param = ir_var(IR_LF, str_val(&function->params[i].name));
         // Define local variable
-        str_add_cstr(&gen->function_header, "DEFVAR LF@");
-        str_add_str(&gen->function_header, &function->params[i].name);
-        str_add_char(&gen->function_header, '\n');
+        ir_add1(header, IR_DEFVAR, param);
         // Pop from stack
-        str_add_cstr(&gen->function_header, "POPS LF@");
-        str_add_str(&gen->function_header, &function->params[i].name);
-        str_add_char(&gen->function_header, '\n');
+        ir_add1(header, IR_POPS, param);
         // Check type
-        str_add_cstr(&gen->function_header, "TYPE GF@?type1 LF@");
-        str_add_str(&gen->function_header, &function->params[i].name);
-        str_add_cstr(&gen->function_header, "\nJUMPIFEQ ");
-        str_add_cstr(&gen->function_header, function_name);
-        str_add_char(&gen->function_header, '!');
-        str_add_int(&gen->function_header, i);
-        str_add_cstr(&gen->function_header, " string@");
+        ir_add2(header, IR_TYPE, TYPE1, param);
+        ir_operand_t type;
         switch (function->params[i].type) {
             case TOK_INT:
-                str_add_cstr(&gen->function_header, "int");
+                type = ir_string("int", 3);
                 break;
             case TOK_FLOAT:
-                str_add_cstr(&gen->function_header, "float");
+                type = ir_string("float", 5);
                 break;
             case TOK_STRING:
-                str_add_cstr(&gen->function_header, "string");
+                type = ir_string("string", 6);
                 break;
             default:
                 error_exit(ERR_INTERNAL);
         }
-        str_add_cstr(&gen->function_header, " GF@?type1\n");
+        ir_add3(header, IR_JUMPIFEQ, ir_label(label, i), type, TYPE1);
 
         if (!function->params[i].required) {
-            str_add_cstr(&gen->function_header, "JUMPIFEQ ");
-            str_add_cstr(&gen->function_header, function_name);
-            str_add_char(&gen->function_header, '!');
-            str_add_int(&gen->function_header, i);
-            str_add_cstr(&gen->function_header, " string@nil GF@?type1\n");
+            ir_add3(header, IR_JUMPIFEQ, ir_label(label, i), ir_string("nil", 3), TYPE1);
         }
 
         // Jump to error if type is not correct
-        str_add_cstr(&gen->function_header, "JUMP !ERR_SEM_CALL\n");
+        ir_add1(header, IR_JUMP, ir_label("!ERR_SEM_CALL", -1));
 
         // Type is ok
-        str_add_cstr(&gen->function_header, "LABEL ");
-        str_add_cstr(&gen->function_header, function_name);
-        str_add_char(&gen->function_header, '!');
-        str_add_int(&gen->function_header, i);
-        str_add_cstr(&gen->function_header, "\n");
+        ir_add1(header, IR_LABEL, ir_label(label, i));
     }
 
-    str_add_cstr(&gen->function_header, "DEFVAR LF@?rettype\n");
+    ir_operand_t rettype = ir_var(IR_LF, "?rettype");
+    ir_add1(header, IR_DEFVAR, rettype);
     switch (function->returns.type) {
         case TOK_INT:
-            str_add_cstr(&gen->function_header, "MOVE LF@?rettype string@int\n");
+            ir_add2(header, IR_MOVE, rettype, ir_string("int", 3));
             break;
         case TOK_FLOAT:
-            str_add_cstr(&gen->function_header, "MOVE LF@?rettype string@float\n");
+            ir_add2(header, IR_MOVE, rettype, ir_string("float", 5));
             break;
         case TOK_STRING:
-            str_add_cstr(&gen->function_header, "MOVE LF@?rettype string@string\n");
+            ir_add2(header, IR_MOVE, rettype, ir_string("string", 6));
             break;
         default:
-            str_add_cstr(&gen->function_header, "MOVE LF@?rettype string@nil\n");
+            ir_add2(header, IR_MOVE, rettype, ir_string("nil", 3));
             break;
     }
 
     // No return where expected
     if (function->returns.type != TOK_VOID && function->returns.required != false) {
-        str_add_cstr(&gen->function, "JUMP !ERR_SEM_CALL\n");
+        ir_add1(&gen->function, IR_JUMP, ir_label("!ERR_SEM_CALL", -1));
     }
 
     // Generate default return from function without passing value
-    str_add_cstr(&gen->function,
-                 "PUSHS nil@nil\n"
-                 "POPFRAME\n"
-                 "RETURN\n");
+    ir_add1(&gen->function, IR_PUSHS, ir_nil());
+    ir_add(&gen->function, IR_POPFRAME);
+    ir_add(&gen->function, IR_RETURN);
+    if (gen->stream != NULL) {
+        // Global code written so far is final, function has to be jumped over
+        gen_flush(gen, &gen->global, &gen->global_text);
+        ir_add1(&gen->functions, IR_JUMP, ir_label("!?global_", gen->stream_count));
+    }
     // Add our complete function to other functions
-    str_add_str(&gen->functions, &gen->function_header);
-    str_add_str(&gen->functions, &gen->function);
-    // Clear current function strings
-    str_clear(&gen->function_header);
-    str_clear(&gen->function);
-    // Set scope back to global
+    ir_code_splice(&gen->functions, &gen->function_header);
+    ir_code_splice(&gen->functions, &gen->function);
+    if (gen->stream != NULL) {
+        ir_add1(&gen->functions, IR_LABEL, ir_label("!?global_", gen->stream_count++));
+    }
+    // Finished function is kept only as text
+    gen_flush(gen, &gen->functions, &gen->functions_text);
+    // Set scope back to global (global variables were forgotten by the function body)
     gen->current = &gen->global;
     gen->current_header = &gen->header;
+    infer_forget(&gen->infer);
 }
 
 void gen_return(gen_t* gen, htab_fun_t* function, int construct_count) {
     if (function != NULL) {
         // Check if function returns value
         if (function->returns.type == TOK_VOID) {
-            str_add_cstr(gen->current_header, "JUMP !ERR_SEM_RET\n");
+            ir_add1(gen->current_header, IR_JUMP, ir_label("!ERR_SEM_RET", -1));
         }
 
         // Check return value type
         // Return value that we got from last expression
-        str_add_cstr(gen->current, "TYPE GF@?type1 GF@?tmp1\n");
+        ir_add2(gen->current, IR_TYPE, TYPE1, TMP1);
         if (!function->returns.required) {
-            str_add_cstr(gen->current, "JUMPIFEQ !return");
-            str_add_int(gen->current, construct_count);
-            str_add_cstr(gen->current, " string@nil GF@?type1\n");
+            ir_add3(gen->current, IR_JUMPIFEQ, ir_label("!return", construct_count),
+                    ir_string("nil", 3), TYPE1);
         }
-        str_add_cstr(gen->current,
-                     "JUMPIFNEQ !ERR_SEM_CALL LF@?rettype GF@?type1\n"
-                     "LABEL !return");
-        str_add_int(gen->current, construct_count);
-        str_add_cstr(gen->current,
-                     "\n"
-                     "PUSHS GF@?tmp1\n"
-                     "POPFRAME\n"
-                     "RETURN\n");
+        ir_add3(gen->current, IR_JUMPIFNEQ, ir_label("!ERR_SEM_CALL", -1),
+                ir_var(IR_LF, "?rettype"), TYPE1);
+        ir_add1(gen->current, IR_LABEL, ir_label("!return", construct_count));
+        ir_add1(gen->current, IR_PUSHS, TMP1);
+        ir_add(gen->current, IR_POPFRAME);
+        ir_add(gen->current, IR_RETURN);
     } else {
         // Return from main scope
-        str_add_cstr(gen->current, "EXIT int@0\n");
+        ir_add1(gen->current, IR_EXIT, ir_int(0));
     }
 }
 
@@ -402,142 +436,166 @@ void gen_return_void(gen_t* gen, htab_fun_t* function) {
     if (function != NULL) {
         // Check if we can return without value
         if (function->returns.type != TOK_VOID && function->returns.required != false) {
-            str_add_cstr(gen->current, "JUMP !ERR_SEM_RET\n");
+            ir_add1(gen->current, IR_JUMP, ir_label("!ERR_SEM_RET", -1));
         }
 
         // Just return without returning value (return null)
-        str_add_cstr(gen->current,
-                     "PUSHS nil@nil\n"
-                     "POPFRAME\n"
-                     "RETURN\n");
+        ir_add1(gen->current, IR_PUSHS, ir_nil());
+        ir_add(gen->current, IR_POPFRAME);
+        ir_add(gen->current, IR_RETURN);
     } else {
         // Return from main scope
-        str_add_cstr(gen->current, "EXIT int@0\n");
+        ir_add1(gen->current, IR_EXIT, ir_int(0));
     }
 }
 
-void gen_function_call(gen_t* gen, bool in_function) {
+void gen_function_call(gen_t* gen, htab_fun_t* function, bool in_function) {
     // Include call parameters
-    str_add_str(gen->current, &gen->params);
-    str_clear(&gen->params);
+    ir_code_splice(gen->current, &gen->params);
 
     // This is special case: If function is "write" (with variable term count)
     // We push number of terms to stack so the function knows how many there are
-    if (strcmp(gen->function_name.val, "write") == 0) {
-        str_add_cstr(gen->current, "PUSHS int@");
-        str_add_int(gen->current, gen->param_count);
-        str_add_char(gen->current, '\n');
+    if (str_val(&gen->function_name) == gen->write_name) {
+        ir_add1(gen->current, IR_PUSHS, ir_int(gen->param_count));
     }
 
-    // Do the actual call
-    str_add_cstr(gen->current, "CALL ");
-    str_add_str(gen->current, &gen->function_name);
-    str_add_cstr(gen->current, "\n");
+    // Do the actual call (function name is interned, view points to it)
+    ir_add1(gen->current, IR_CALL, ir_label(str_val(&gen->function_name), -1));
     // Cleanup
     gen->param_count = 0;
-    str_clear(&gen->function_name);
+    gen->function_name = str_new_view("", 0);
 
     // Get returned value
-    if (strlen(gen->variable.val) != 0) {
-        str_add_cstr(gen->current, "POPS ");
-        if (in_function) {
-            str_add_cstr(gen->current, "LF@");
-        } else {
-            str_add_cstr(gen->current, "GF@");
-        }
-        str_add_str(gen->current, &gen->variable);
-        str_add_char(gen->current, '\n');
+    if (str_len(&gen->variable) != 0) {
+        const char* name = intern(str_val(&gen->variable), str_len(&gen->variable));
+        ir_add1(gen->current, IR_POPS, gen_var(name, in_function));
+        infer_assign(&gen->infer, name, infer_call(function));
     }
+    gen->exp_type = INFER_UNKNOWN;
+    gen_flush_global(gen);
 }
 
 void gen_function_call_frame(gen_t* gen, token_t* token) {
     // Check if function is declared
-    str_add_cstr(gen->current, "JUMPIFEQ !ERR_CALL bool@false GF@?");
-    str_add_cstr(gen->current, token->attr.val_s.val);
-    str_add_cstr(gen->current, "$declared\n");
-    // Save function name for future use (actual calling)
-    str_add_str(&gen->function_name, &token->attr.val_s);
+    ir_add3(gen->current, IR_JUMPIFEQ, ir_label("!ERR_CALL", -1), ir_bool(false),
+            ir_var(IR_GF, gen_declared_name(token->attr.val_s)));
+    // Save function name for future use (actual calling), it is interned so view is enough
+    gen->function_name = str_new_view(token->attr.val_s, intern_len(token->attr.val_s));
 }
 
 /**
- * @brief Generate expression instructions from expression tree (post-order traversal)
+ * @brief Generate arithmetic operation (+, -, *) with inline path for operands of the same type
+ *
+ * Int/int and float/float operands are computed directly, everything else (conversions, null,
+ * type errors) is called in the slow path helper. If inferred types of both operands are the same
+ * number type, only the stack instruction is generated.
  *
  * @param gen Generator instance
- * @param root Root node
- * @param in_function Whether are we in function
+ * @param op Instruction of the operation (IR_ADD, IR_SUB, IR_MUL)
+ * @param stack_op Stack instruction of the operation (IR_ADDS, IR_SUBS, IR_MULS)
+ * @param slow Name of slow path helper
+ * @param a Inferred type of left operand
+ * @param b Inferred type of right operand
  */
-void gen_exp_from_tree(gen_t* gen, token_term_t* root, bool in_function) {
-    // Parent is leaf
-    if (root == NULL) {
+static void gen_arith(gen_t* gen,
+                      ir_opcode_t op,
+                      ir_opcode_t stack_op,
+                      const char* slow,
+                      infer_type_t a,
+                      infer_type_t b) {
+    ir_code_t* code = gen->current;
+    // Operands are defined when they are on the stack
+    a &= ~INFER_UNDEF;
+    b &= ~INFER_UNDEF;
+    if (a == b && (a == INFER_INT || a == INFER_FLOAT)) {
+        ir_add(code, stack_op);
         return;
     }
+    const int id = gen->arith_count++;
+    ir_add1(code, IR_POPS, TMP2);
+    ir_add1(code, IR_POPS, TMP1);
+    ir_add2(code, IR_TYPE, TYPE1, TMP1);
+    ir_add2(code, IR_TYPE, TYPE2, TMP2);
+    ir_add3(code, IR_JUMPIFNEQ, ir_label("!arith_slow_", id), TYPE1, TYPE2);
+    ir_add3(code, IR_JUMPIFEQ, ir_label("!arith_fast_", id), TYPE1, ir_string("int", 3));
+    ir_add3(code, IR_JUMPIFEQ, ir_label("!arith_fast_", id), TYPE1, ir_string("float", 5));
+    // Slow path
+    ir_add1(code, IR_LABEL, ir_label("!arith_slow_", id));
+    ir_add1(code, IR_CALL, ir_label(slow, -1));
+    ir_add1(code, IR_JUMP, ir_label("!arith_end_", id));
+    // Fast path
+    ir_add1(code, IR_LABEL, ir_label("!arith_fast_", id));
+    ir_add3(code, op, TMP1, TMP1, TMP2);
+    ir_add1(code, IR_PUSHS, TMP1);
+    ir_add1(code, IR_LABEL, ir_label("!arith_end_", id));
+}
 
-    // Generate children
-    gen_exp_from_tree(gen, root->left, in_function);
-    gen_exp_from_tree(gen, root->right, in_function);
-
-    // If token is literal / variable (leaf node) then just generate value
-    if (token_is_literal(&root->value) || root->value.type == TOK_VAR) {
-        gen_value(gen->current, &root->value, in_function);
-        str_add_cstr(gen->current, "\n");
+/**
+ * @brief Generate instructions of one item of postfix expression
+ *
+ * @param gen Generator instance
+ * @param token Operand (pushed on the stack) or operator (applied to the top of the stack)
+ * @param type Inferred type of the operand
+ * @param a Inferred type of left operand of the operator
+ * @param b Inferred type of right operand of the operator
+ * @param in_function Whether are we in function
+ */
+static void gen_exp_item(gen_t* gen,
+                         token_t* token,
+                         infer_type_t type,
+                         infer_type_t a,
+                         infer_type_t b,
+                         bool in_function) {
+    ir_code_t* code = gen->current;
+    // If token is literal / variable then just generate value
+    if (token_is_literal(token) || token->type == TOK_VAR) {
+        gen_value(code, token, type, in_function);
     } else {
         // Do operations
-        switch (root->value.type) {
+        switch (token->type) {
             case TOK_PLUS:
-                str_add_cstr(gen->current,
-                             "CALL !num_prepare\n"
-                             "ADDS\n");
+                gen_arith(gen, IR_ADD, IR_ADDS, "!arith_add", a, b);
                 break;
             case TOK_MINUS:
-                str_add_cstr(gen->current,
-                             "CALL !num_prepare\n"
-                             "SUBS\n");
+                gen_arith(gen, IR_SUB, IR_SUBS, "!arith_sub", a, b);
                 break;
             case TOK_MULTIPLY:
-                str_add_cstr(gen->current,
-                             "CALL !num_prepare\n"
-                             "MULS\n");
+                gen_arith(gen, IR_MUL, IR_MULS, "!arith_mul", a, b);
                 break;
             case TOK_DIVIDE:
-                str_add_cstr(gen->current,
-                             "CALL !num_prepare_div\n"
-                             "DIVS\n");
+                ir_add1(code, IR_CALL, ir_label("!num_prepare_div", -1));
+                ir_add(code, IR_DIVS);
                 break;
             case TOK_DOT:
-                str_add_cstr(gen->current, "CALL !concat\n");
+                ir_add1(code, IR_CALL, ir_label("!concat", -1));
                 break;
             case TOK_EQUALS:
-                str_add_cstr(gen->current, "CALL !equals\n");
+                ir_add1(code, IR_CALL, ir_label("!equals", -1));
                 break;
             case TOK_NEQUALS:
-                str_add_cstr(gen->current,
-                             "CALL !equals\n"
-                             "NOTS\n");
+                ir_add1(code, IR_CALL, ir_label("!equals", -1));
+                ir_add(code, IR_NOTS);
                 break;
             case TOK_LESS:
-                str_add_cstr(gen->current,
-                             "POPS GF@?tmp1\n"
-                             "POPS GF@?tmp2\n"
-                             "CALL !greater\n");
+                ir_add1(code, IR_POPS, TMP1);
+                ir_add1(code, IR_POPS, TMP2);
+                ir_add1(code, IR_CALL, ir_label("!greater", -1));
                 break;
             case TOK_LESS_E:
-                str_add_cstr(gen->current,
-                             "POPS GF@?tmp1\n"
-                             "POPS GF@?tmp2\n"
-                             "CALL !greater_equals\n");
+                ir_add1(code, IR_POPS, TMP1);
+                ir_add1(code, IR_POPS, TMP2);
+                ir_add1(code, IR_CALL, ir_label("!greater_equals", -1));
                 break;
             case TOK_GREATER:
-                str_add_cstr(gen->current,
-                             "POPS GF@?tmp2\n"
-                             "POPS GF@?tmp1\n"
-                             "CALL !greater\n");
+                ir_add1(code, IR_POPS, TMP2);
+                ir_add1(code, IR_POPS, TMP1);
+                ir_add1(code, IR_CALL, ir_label("!greater", -1));
                 break;
             case TOK_GREATER_E:
                 // Greater-than-equals is negated less-than
-                str_add_cstr(gen->current,
-                             "POPS GF@?tmp2\n"
-                             "POPS GF@?tmp1\n"
-                             "CALL !greater_equals\n");
+                ir_add1(code, IR_POPS, TMP2);
+                ir_add1(code, IR_POPS, TMP1);
+                ir_add1(code, IR_CALL, ir_label("!greater_equals", -1));
                 break;
             default:
                 // This shouldn't happen
@@ -546,64 +604,84 @@ void gen_exp_from_tree(gen_t* gen, token_term_t* root, bool in_function) {
     }
 }
 
-void gen_exp(gen_t* gen, token_term_t* root, bool in_function) {
-    // Generate actual expression from tree
-    gen_exp_from_tree(gen, root, in_function);
+void gen_exp(gen_t* gen, postfix_t* postfix, bool in_function) {
+    infer_type_t* types = arena_alloc(postfix->arena, postfix->len * sizeof(infer_type_t));
+    gen->exp_type = infer_exp(&gen->infer, postfix, types);
+    // Postfix order is exactly the order of stack instructions, stack of node indexes follows it
+    int* stack = arena_alloc(postfix->arena, postfix->len * sizeof(int));
+    int top = 0;
+    for (int i = 0; i < postfix->len; i++) {
+        token_t* token = &postfix->items[i];
+        if (token_is_literal(token) || token->type == TOK_VAR) {
+            gen_exp_item(gen, token, types[i], 0, 0, in_function);
+        } else {
+            top -= 2;
+            gen_exp_item(gen, token, types[i], types[stack[top]], types[stack[top + 1]],
+                         in_function);
+        }
+        stack[top++] = i;
+    }
 
     // Return expression / expression without assignment
-    if (gen->variable.len == 0) {
-        str_add_cstr(gen->current, "POPS GF@?tmp1\n");
+    if (str_len(&gen->variable) == 0) {
+        ir_add1(gen->current, IR_POPS, TMP1);
         // Assign (pop from stack) expression result to saved variable name
     } else {
-        if (in_function) {
-            str_add_cstr(gen->current, "POPS LF@");
-        } else {
-            str_add_cstr(gen->current, "POPS GF@");
-        }
-        str_add_str(gen->current, &gen->variable);
-        str_add_cstr(gen->current, "\n");
+        const char* name = intern(str_val(&gen->variable), str_len(&gen->variable));
+        ir_add1(gen->current, IR_POPS, gen_var(name, in_function));
+        infer_assign(&gen->infer, name, gen->exp_type);
     }
+    gen_flush_global(gen);
 }
 
 void gen_function_call_param(gen_t* gen, token_t* token, bool in_function) {
     // Add instruction parameters to stack
     // We have to push them in reverse order
-    str_t str = str_new();
-    gen_value(&str, token, in_function);
-    str_add_cstr(&str, "\n");
-    str_add_str(&str, &gen->params);
-    str_clear(&gen->params);
-    str_add_str(&gen->params, &str);
-    str_free(&str);
+    ir_code_t param = ir_code_new();
+    infer_type_t type = INFER_UNKNOWN;
+    if (token->type == TOK_VAR) {
+        type = infer_var(&gen->infer, token->attr.val_s);
+    }
+    gen_value(&param, token, type, in_function);
+    ir_code_splice(&param, &gen->params);
+    ir_code_free(&gen->params);
+    gen->params = param;
 
     gen->param_count++;
 }
 
 void gen_variable_def(gen_t* gen, token_t* token, bool in_function) {
     // Define new variable based on scope
-    str_add_cstr(gen->current_header, "DEFVAR ");
-    if (in_function) {
-        str_add_cstr(gen->current_header, "LF@");
-    } else {
-        str_add_cstr(gen->current_header, "GF@");
-    }
-    str_add_str(gen->current_header, &token->attr.val_s);
-    str_add_char(gen->current_header, '\n');
+    ir_add1(gen->current_header, IR_DEFVAR, gen_var(token->attr.val_s, in_function));
 }
 
 void gen_free(gen_t* gen) {
-    str_free(&gen->header);
-    str_free(&gen->global);
-    str_free(&gen->functions);
-    str_free(&gen->function_header);
-    str_free(&gen->function);
+    ir_code_free(&gen->header);
+    ir_code_free(&gen->global);
+    ir_code_free(&gen->functions);
+    ir_code_free(&gen->function_header);
+    ir_code_free(&gen->function);
     str_free(&gen->function_name);
     str_free(&gen->variable);
-    str_free(&gen->params);
+    ir_code_free(&gen->params);
+    rope_free(&gen->global_text);
+    rope_free(&gen->functions_text);
+    infer_free(&gen->infer);
 }
 
 void gen_emit(gen_t* gen) {
-    str_print(&gen->header);
-    str_print(&gen->global);
-    str_print(&gen->functions);
+    if (gen->stream != NULL) {
+        // Global code ends with exit, header is reached by the first jump and continues with it
+        gen_flush(gen, &gen->global, &gen->global_text);
+        ir_add1(&gen->functions, IR_LABEL, ir_label("!?header", -1));
+        ir_code_splice(&gen->functions, &gen->header);
+        ir_add1(&gen->functions, IR_JUMP, ir_label("!?global", -1));
+        gen_flush(gen, &gen->functions, &gen->functions_text);
+        return;
+    }
+    // Whole program is written only now (header is complete at the end)
+    gen_flush(gen, &gen->global, &gen->global_text);
+    ir_code_write(&gen->header, stdout);
+    rope_write(&gen->global_text, stdout);
+    rope_write(&gen->functions_text, stdout);
 }
@@ -12,23 +12,35 @@
 #ifndef __GEN_H__
 #define __GEN_H__
 
+#include <stdio.h>
+#include "infer.h"
+#include "ir.h"
+#include "postfix.h"
+#include "rope.h"
 #include "str.h"
 #include "symtable.h"
 #include "token.h"
-#include "token_term.h"
 
 typedef struct {
-    str_t header;           // Global header (init, definition of global variables)
-    str_t global;           // Global code
-    str_t functions;        // All functions
-    str_t function_header;  // Current function header (definition of local variables)
-    str_t function;         // Current function code
-    str_t function_name;    // Current function name
-    str_t variable;         // Current variable name
-    str_t params;           // Params for funcion calls
-    int param_count;        // Number of call params
-    str_t* current;         // Pointer to current string (function or global)
-    str_t* current_header;  // Pointer to current header (function or global)
+    ir_code_t header;           // Global header (init, definition of global variables)
+    ir_code_t global;           // Global code not printed yet
+    ir_code_t functions;        // Function being added to the text
+    rope_t global_text;         // Printed global code (written at the end)
+    rope_t functions_text;      // Printed finished functions (written at the end)
+    ir_code_t function_header;  // Current function header (definition of local variables)
+    ir_code_t function;         // Current function code
+    str_t function_name;        // Current function name (view of interned name)
+    const char* write_name;     // Interned "write" (compared by pointer)
+    str_t variable;             // Current variable name
+    ir_code_t params;           // Params for funcion calls
+    int param_count;            // Number of call params
+    ir_code_t* current;         // Pointer to current code (function or global)
+    ir_code_t* current_header;  // Pointer to current header (function or global)
+    FILE* stream;               // Output of finished code (NULL if all code is emitted at the end)
+    int stream_count;           // Counter of functions jumped over in streamed global code
+    int arith_count;            // Counter of inline arithmetic operations (for unique labels)
+    infer_t infer;              // Types of variables at the current point of the program
+    infer_type_t exp_type;      // Type of the last expression (value in ?tmp1)
 } gen_t;
 
 /**
@@ -39,7 +51,20 @@ typedef struct {
 gen_t gen_new();
 
 /**
- * @brief Emit final code to stdout
+ * @brief Initialize new generator which writes code as soon as it is finished
+ *
+ * Finished functions and blocks of global code are written immediately, only the header (global
+ * variable definitions) is kept until the end. Program starts with a jump over the streamed code
+ * to the header, which jumps back to the global code. Memory is proportional to the largest
+ * function instead of the whole program.
+ *
+ * @param stream Output
+ * @return Initiazed generator
+ */
+gen_t gen_new_streaming(FILE* stream);
+
+/**
+ * @brief Emit final code to stdout (rest of the code when streaming)
  *
  * @param gen Generator instance
  */
@@ -116,6 +141,14 @@ void gen_loop_end(gen_t* gen, int construct_count);
  */
 void gen_function(gen_t* gen, token_t* token);
 
+/**
+ * @brief Start of function body (parameters and return type are known)
+ *
+ * @param gen Generator instance
+ * @param function Pointer to function data in table
+ */
+void gen_function_body(gen_t* gen, htab_fun_t* function);
+
 /**
  * @brief Generate function end
  *
@@ -128,9 +161,10 @@ void gen_function_end(gen_t* gen, htab_fun_t* function, char* function_name);
  * @brief Generate function call
  *
  * @param gen Generator instance
+ * @param function Called function (type of returned value)
  * @param in_function Whether are we in function scope
  */
-void gen_function_call(gen_t* gen, bool in_function);
+void gen_function_call(gen_t* gen, htab_fun_t* function, bool in_function);
 
 /**
  * @brief Generate function call frame
@@ -159,13 +193,13 @@ void gen_function_call_param(gen_t* gen, token_t* token, bool in_function);
 void gen_variable_def(gen_t* gen, token_t* token, bool in_function);
 
 /**
- * @brief Generate expression from expression tree generated by exp.c
+ * @brief Generate expression from postfix expression generated by exp.c
  *
  * @param gen Generator instance
- * @param root Root node
+ * @param postfix Postfix expression
  * @param in_function Wheter are we in function scope
  */
-void gen_exp(gen_t* gen, token_term_t* root, bool in_function);
+void gen_exp(gen_t* gen, postfix_t* postfix, bool in_function);
 
 /**
  * @brief Generate return (with value - from expression)
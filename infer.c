@@ -0,0 +1,269 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file infer.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Static type inference for variables and expressions
+ */
+
+#include "infer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "intern.h"
+
+#define INIT_SIZE 16
+
+infer_t infer_new() {
+    return (infer_t){
+        .vars = NULL,
+        .vars_size = 0,
+        .stamp = 0,
+        .kills = NULL,
+        .kills_len = 0,
+        .kills_size = 0,
+        .constructs = NULL,
+        .constructs_len = 0,
+        .constructs_size = 0,
+    };
+}
+
+void infer_free(infer_t* infer) {
+    free(infer->vars);
+    free(infer->kills);
+    free(infer->constructs);
+    *infer = infer_new();
+}
+
+/**
+ * @brief Grow array so it has space for at least n items (new items are zeroed)
+ *
+ * @param array Pointer to array
+ * @param size Pointer to capacity
+ * @param n Required capacity
+ * @param item Size of one item
+ */
+static void infer_reserve(void* array, size_t* size, size_t n, size_t item) {
+    if (n <= *size) {
+        return;
+    }
+    size_t new_size = *size == 0 ? INIT_SIZE : *size;
+    while (new_size < n) {
+        new_size *= 2;
+    }
+    void** ptr = array;
+    char* items = realloc(*ptr, new_size * item);
+    if (items == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    memset(items + *size * item, 0, (new_size - *size) * item);
+    *ptr = items;
+    *size = new_size;
+}
+
+infer_type_t infer_declared(token_type_t type, bool required) {
+    infer_type_t result;
+    switch (type) {
+        case TOK_INT:
+            result = INFER_INT;
+            break;
+        case TOK_FLOAT:
+            result = INFER_FLOAT;
+            break;
+        case TOK_STRING:
+            result = INFER_STRING;
+            break;
+        case TOK_VOID:
+            return INFER_NIL;
+        default:
+            return INFER_UNKNOWN & ~INFER_UNDEF;
+    }
+    return required ? result : result | INFER_NIL;
+}
+
+infer_type_t infer_call(htab_fun_t* function) {
+    if (function == NULL || !function->defined) {
+        return INFER_UNKNOWN & ~INFER_UNDEF;
+    }
+    return infer_declared(function->returns.type, function->returns.required);
+}
+
+/**
+ * @brief Check if assignment with the stamp was forgotten
+ *
+ * @param infer Inference state
+ * @param stamp Stamp of assignment
+ */
+static bool infer_killed(infer_t* infer, size_t stamp) {
+    // Binary search of the last range starting below the stamp
+    size_t lo = 0;
+    size_t hi = infer->kills_len;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (infer->kills[mid].lo < stamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo > 0 && stamp <= infer->kills[lo - 1].hi;
+}
+
+infer_type_t infer_var(infer_t* infer, const char* name) {
+    uint32_t id = intern_id(name);
+    if (id >= infer->vars_size) {
+        return INFER_UNKNOWN;
+    }
+    infer_var_t* var = &infer->vars[id];
+    if (var->stamp == 0 || infer_killed(infer, var->stamp)) {
+        return INFER_UNKNOWN;
+    }
+    return var->type;
+}
+
+void infer_assign(infer_t* infer, const char* name, infer_type_t type) {
+    uint32_t id = intern_id(name);
+    infer_reserve(&infer->vars, &infer->vars_size, (size_t)id + 1, sizeof(infer_var_t));
+    infer->vars[id].type = type & ~INFER_UNDEF;
+    infer->vars[id].stamp = ++infer->stamp;
+}
+
+/**
+ * @brief Forget all assignments after the stamp
+ *
+ * @param infer Inference state
+ * @param from Stamp (assignments after it are forgotten)
+ */
+static void infer_kill(infer_t* infer, size_t from) {
+    if (from >= infer->stamp) {
+        return;
+    }
+    // Ranges inside of the new one are replaced by it
+    while (infer->kills_len > 0 && infer->kills[infer->kills_len - 1].lo >= from) {
+        infer->kills_len--;
+    }
+    if (infer->kills_len > 0 && infer->kills[infer->kills_len - 1].hi >= from) {
+        infer->kills[infer->kills_len - 1].hi = infer->stamp;
+        return;
+    }
+    infer_reserve(&infer->kills, &infer->kills_size, infer->kills_len + 1, sizeof(infer_kill_t));
+    infer->kills[infer->kills_len++] = (infer_kill_t){.lo = from, .hi = infer->stamp};
+}
+
+void infer_forget(infer_t* infer) {
+    infer_kill(infer, 0);
+}
+
+void infer_if(infer_t* infer) {
+    infer_reserve(&infer->constructs, &infer->constructs_size, infer->constructs_len + 1,
+                  sizeof(size_t));
+    infer->constructs[infer->constructs_len++] = infer->stamp;
+}
+
+void infer_if_join(infer_t* infer, bool end) {
+    if (infer->constructs_len == 0) {
+        error_exit(ERR_INTERNAL);
+    }
+    infer_kill(infer, infer->constructs[infer->constructs_len - 1]);
+    if (end) {
+        infer->constructs_len--;
+    }
+}
+
+void infer_function(infer_t* infer, htab_fun_t* function) {
+    infer_forget(infer);
+    // Types of parameters are checked when the function is called
+    for (int i = 0; i < function->param_count; i++) {
+        htab_param_t* param = &function->params[i];
+        const char* name = intern(str_val(&param->name), str_len(&param->name));
+        infer_assign(infer, name, infer_declared(param->type, param->required));
+    }
+}
+
+infer_type_t infer_binary(token_type_t op, infer_type_t a, infer_type_t b) {
+    // Reading undefined variable fails, so the operation is done only with defined values
+    a &= ~INFER_UNDEF;
+    b &= ~INFER_UNDEF;
+    // Null is used as int 0 in arithmetic
+    if (a & INFER_NIL) {
+        a = (a & ~INFER_NIL) | INFER_INT;
+    }
+    if (b & INFER_NIL) {
+        b = (b & ~INFER_NIL) | INFER_INT;
+    }
+    const infer_type_t num = INFER_INT | INFER_FLOAT;
+    switch (op) {
+        case TOK_PLUS:
+        case TOK_MINUS:
+        case TOK_MULTIPLY: {
+            infer_type_t result = 0;
+            if ((a & INFER_INT) && (b & INFER_INT)) {
+                result |= INFER_INT;
+            }
+            if (((a & INFER_FLOAT) && (b & num)) || ((b & INFER_FLOAT) && (a & num))) {
+                result |= INFER_FLOAT;
+            }
+            return result;
+        }
+        case TOK_DIVIDE:
+            return (a & num) && (b & num) ? INFER_FLOAT : 0;
+        case TOK_DOT:
+            return INFER_STRING;
+        case TOK_LESS:
+        case TOK_LESS_E:
+        case TOK_GREATER:
+        case TOK_GREATER_E:
+        case TOK_EQUALS:
+        case TOK_NEQUALS:
+            return INFER_BOOL;
+        default:
+            return INFER_UNKNOWN & ~INFER_UNDEF;
+    }
+}
+
+/**
+ * @brief Type of literal or variable
+ *
+ * @param infer Inference state
+ * @param token Operand
+ */
+static infer_type_t infer_operand(infer_t* infer, token_t* token) {
+    switch (token->type) {
+        case TOK_INT_LIT:
+            return INFER_INT;
+        case TOK_FLOAT_LIT:
+            return INFER_FLOAT;
+        case TOK_STR_LIT:
+            return INFER_STRING;
+        case TOK_NULL:
+            return INFER_NIL;
+        case TOK_VAR:
+            return infer_var(infer, token->attr.val_s);
+        default:
+            return INFER_UNKNOWN;
+    }
+}
+
+infer_type_t infer_exp(infer_t* infer, postfix_t* postfix, infer_type_t* types) {
+    // Stack of indexes of operand nodes
+    int* stack = arena_alloc(postfix->arena, postfix->len * sizeof(int));
+    int top = 0;
+    for (int i = 0; i < postfix->len; i++) {
+        token_t* token = &postfix->items[i];
+        if (token_is_literal(token) || token->type == TOK_VAR) {
+            types[i] = infer_operand(infer, token);
+        } else {
+            if (top < 2) {
+                error_exit(ERR_INTERNAL);
+            }
+            int b = stack[--top];
+            int a = stack[--top];
+            types[i] = infer_binary(token->type, types[a], types[b]);
+        }
+        stack[top++] = i;
+    }
+    return postfix->len > 0 ? types[postfix->len - 1] & ~INFER_UNDEF : INFER_UNKNOWN;
+}
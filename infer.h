@@ -0,0 +1,161 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file infer.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Static type inference for variables and expressions
+ *
+ * Type is a set of possible runtime types (?int is int | nil, unknown is everything). Program is
+ * parsed in one pass, so the inference follows the generator: assignments set types of variables,
+ * control flow joins forget them. Labels of if-else forget only variables assigned inside of the
+ * construct, loop labels and function boundaries forget everything.
+ */
+
+#ifndef __INFER_H__
+#define __INFER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "postfix.h"
+#include "symtable.h"
+#include "token.h"
+
+typedef uint8_t infer_type_t;
+
+#define INFER_INT 0x01
+#define INFER_FLOAT 0x02
+#define INFER_STRING 0x04
+#define INFER_NIL 0x08
+#define INFER_BOOL 0x10
+#define INFER_UNDEF 0x20  // Variable may be undefined (reading it is an error)
+#define INFER_UNKNOWN 0x3f
+
+typedef struct {
+    infer_type_t type;  // Type after the last assignment
+    size_t stamp;       // Stamp of the last assignment (0 if never assigned)
+} infer_var_t;
+
+typedef struct {
+    size_t lo;  // Forgotten stamps are greater than lo
+    size_t hi;  // and not greater than hi
+} infer_kill_t;
+
+typedef struct {
+    infer_var_t* vars;    // Variables indexed by intern id
+    size_t vars_size;     // Number of variables
+    size_t stamp;         // Stamp of the last assignment
+    infer_kill_t* kills;  // Sorted disjoint ranges of forgotten assignments
+    size_t kills_len;     // Number of ranges
+    size_t kills_size;    // Capacity of ranges
+    size_t* constructs;   // Stamps at starts of open if-else constructs
+    size_t constructs_len;
+    size_t constructs_size;
+} infer_t;
+
+/**
+ * @brief Initialize inference state (all variables are unknown)
+ *
+ * @return Inference state
+ */
+infer_t infer_new();
+
+/**
+ * @brief Free inference state
+ *
+ * @param infer Inference state
+ */
+void infer_free(infer_t* infer);
+
+/**
+ * @brief Type of declared parameter or return type
+ *
+ * @param type Type token type (TOK_INT, TOK_FLOAT, TOK_STRING, TOK_VOID)
+ * @param required False if the type is nullable (?int)
+ * @return Type
+ */
+infer_type_t infer_declared(token_type_t type, bool required);
+
+/**
+ * @brief Type of value returned by function call
+ *
+ * @param function Called function (unknown if it isn't defined yet)
+ * @return Type
+ */
+infer_type_t infer_call(htab_fun_t* function);
+
+/**
+ * @brief Current type of variable
+ *
+ * @param infer Inference state
+ * @param name Interned name
+ * @return Type (with INFER_UNDEF if the variable may not be assigned)
+ */
+infer_type_t infer_var(infer_t* infer, const char* name);
+
+/**
+ * @brief Assign type to variable
+ *
+ * @param infer Inference state
+ * @param name Interned name
+ * @param type Type of assigned value
+ */
+void infer_assign(infer_t* infer, const char* name, infer_type_t type);
+
+/**
+ * @brief Type of result of binary operation
+ *
+ * @param op Operator token type
+ * @param a Type of left operand
+ * @param b Type of right operand
+ * @return Type (empty if operation always fails)
+ */
+infer_type_t infer_binary(token_type_t op, infer_type_t a, infer_type_t b);
+
+/**
+ * @brief Infer types of all nodes of postfix expression
+ *
+ * Node types are types of subexpressions ending at the item, operands which are variables keep
+ * INFER_UNDEF if they may be undefined.
+ *
+ * @param infer Inference state
+ * @param postfix Expression
+ * @param types Destination for the node types (postfix->len items)
+ * @return Type of the whole expression
+ */
+infer_type_t infer_exp(infer_t* infer, postfix_t* postfix, infer_type_t* types);
+
+/**
+ * @brief Start of function body, only parameters are known
+ *
+ * @param infer Inference state
+ * @param function Function with parameter types
+ */
+void infer_function(infer_t* infer, htab_fun_t* function);
+
+/**
+ * @brief Forget types of all variables (loop labels, function boundaries)
+ *
+ * @param infer Inference state
+ */
+void infer_forget(infer_t* infer);
+
+/**
+ * @brief Start of if-else construct (after the condition)
+ *
+ * @param infer Inference state
+ */
+void infer_if(infer_t* infer);
+
+/**
+ * @brief Start of else branch or end of the construct, variables assigned in the construct are
+ * forgotten
+ *
+ * @param infer Inference state
+ * @param end Whether this is end of the construct
+ */
+void infer_if_join(infer_t* infer, bool end);
+
+#endif  // __INFER_H__
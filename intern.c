@@ -0,0 +1,159 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file intern.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Global string interning pool (open addressing table, strings stored in blocks)
+ */
+
+#include "intern.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+
+#define INIT_SLOTS 256
+#define BLOCK_SIZE 65536
+
+// Block of memory for interned strings (never moved, so pointers are stable)
+typedef struct intern_block {
+    struct intern_block* next;
+    size_t used;
+    size_t size;
+    alignas(intern_entry_t) char data[];
+} intern_block_t;
+
+// The pool
+static struct {
+    const char** slots;     // Interned strings (NULL = empty slot)
+    size_t slot_count;      // Number of slots (power of two)
+    size_t count;           // Number of interned strings
+    intern_block_t* block;  // Current block (head of the list)
+    size_t lookups;         // Number of intern calls
+    size_t hits;            // Number of intern calls which found existing string
+    size_t bytes;           // Memory used by strings
+} pool;
+
+/**
+ * @brief Hash function (same as the one used by the symbol table before interning)
+ */
+static uint32_t intern_hash_function(const char* str, size_t len) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < len; i++) {
+        h = intern_hash_step(h, str[i]);
+    }
+    return h;
+}
+
+/**
+ * @brief Allocate memory for new entry
+ *
+ * @param size Entry size
+ * @return Memory for the entry (aligned for intern_entry_t)
+ */
+static intern_entry_t* intern_alloc(size_t size) {
+    size = (size + alignof(intern_entry_t) - 1) & ~(alignof(intern_entry_t) - 1);
+    if (pool.block == NULL || pool.block->used + size > pool.block->size) {
+        size_t block_size = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+        intern_block_t* block = malloc(sizeof(intern_block_t) + block_size);
+        if (block == NULL) {
+            error_exit(ERR_INTERNAL);
+        }
+        block->next = pool.block;
+        block->used = 0;
+        block->size = block_size;
+        pool.block = block;
+    }
+    intern_entry_t* entry = (intern_entry_t*)(pool.block->data + pool.block->used);
+    pool.block->used += size;
+    pool.bytes += size;
+    return entry;
+}
+
+/**
+ * @brief Double number of slots
+ */
+static void intern_grow() {
+    size_t new_count = pool.slot_count == 0 ? INIT_SLOTS : pool.slot_count * 2;
+    const char** new_slots = calloc(new_count, sizeof(const char*));
+    if (new_slots == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+
+    // Rehash existing strings (hash is stored in the entry)
+    for (size_t i = 0; i < pool.slot_count; i++) {
+        if (pool.slots[i] != NULL) {
+            size_t index = intern_hash(pool.slots[i]) & (new_count - 1);
+            while (new_slots[index] != NULL) {
+                index = (index + 1) & (new_count - 1);
+            }
+            new_slots[index] = pool.slots[i];
+        }
+    }
+
+    free(pool.slots);
+    pool.slots = new_slots;
+    pool.slot_count = new_count;
+}
+
+const char* intern(const char* str, size_t len) {
+    return intern_hashed(str, len, intern_hash_function(str, len));
+}
+
+const char* intern_hashed(const char* str, size_t len, uint32_t hash) {
+    pool.lookups++;
+    // Keep load factor under 1/2
+    if ((pool.count + 1) * 2 > pool.slot_count) {
+        intern_grow();
+    }
+
+    // Linear probing
+    size_t index = hash & (pool.slot_count - 1);
+    while (pool.slots[index] != NULL) {
+        const intern_entry_t* entry = intern_entry(pool.slots[index]);
+        if (entry->hash == hash && entry->len == len && memcmp(entry->str, str, len) == 0) {
+            pool.hits++;
+            return entry->str;
+        }
+        index = (index + 1) & (pool.slot_count - 1);
+    }
+
+    // Not found, create new entry
+    intern_entry_t* entry = intern_alloc(sizeof(intern_entry_t) + len + 1);
+    entry->id = (uint32_t)pool.count;
+    entry->hash = hash;
+    entry->len = len;
+    memcpy(entry->str, str, len);
+    entry->str[len] = '\0';
+
+    pool.slots[index] = entry->str;
+    pool.count++;
+    return entry->str;
+}
+
+const char* intern_cstr(const char* cstr) {
+    return intern(cstr, strlen(cstr));
+}
+
+size_t intern_count() {
+    return pool.count;
+}
+
+void intern_print_stats(FILE* out) {
+    fprintf(out, "intern: %zu strings, %zu lookups, %zu hits (%.1f %%), %zu bytes\n", pool.count,
+            pool.lookups, pool.hits, pool.lookups ? 100.0 * pool.hits / pool.lookups : 0.0,
+            pool.bytes);
+}
+
+void intern_free() {
+    while (pool.block != NULL) {
+        intern_block_t* next = pool.block->next;
+        free(pool.block);
+        pool.block = next;
+    }
+    free(pool.slots);
+    memset(&pool, 0, sizeof(pool));
+}
@@ -0,0 +1,122 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file intern.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for global string interning pool
+ *
+ * Every distinct identifier is stored exactly once, so interned strings can be compared by
+ * pointer. Interned strings are null terminated and stay valid until intern_free.
+ */
+
+#ifndef __INTERN_H__
+#define __INTERN_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Interned string (text is stored right after the header)
+ */
+typedef struct {
+    uint32_t id;    // Small unique number (order of interning)
+    uint32_t hash;  // Hash of the text
+    size_t len;     // Text length
+    char str[];     // Null terminated text
+} intern_entry_t;
+
+/**
+ * @brief Add one character to hash of interned string (start with 0)
+ *
+ * Scanner uses it to compute hash while it reads the name, so intern doesn't have to read it again.
+ *
+ * @param hash Hash of previous characters
+ * @param c Next character
+ * @return Hash including c
+ */
+static inline uint32_t intern_hash_step(uint32_t hash, char c) {
+    return 65599 * hash + (unsigned char)c;
+}
+
+/**
+ * @brief Intern string
+ *
+ * @param str Characters (don't have to be null terminated)
+ * @param len Number of characters
+ * @return Interned string (same pointer for same text)
+ */
+const char* intern(const char* str, size_t len);
+
+/**
+ * @brief Intern string with already computed hash
+ *
+ * @param str Characters (don't have to be null terminated)
+ * @param len Number of characters
+ * @param hash Hash of the characters (computed by intern_hash_step)
+ * @return Interned string (same pointer for same text)
+ */
+const char* intern_hashed(const char* str, size_t len, uint32_t hash);
+
+/**
+ * @brief Intern c-string
+ *
+ * @param cstr C-String
+ * @return Interned string (same pointer for same text)
+ */
+const char* intern_cstr(const char* cstr);
+
+/**
+ * @brief Get header of interned string
+ *
+ * @param interned Interned string
+ * @return Header
+ */
+static inline const intern_entry_t* intern_entry(const char* interned) {
+    return (const intern_entry_t*)(interned - offsetof(intern_entry_t, str));
+}
+
+/**
+ * @brief Get unique number of interned string
+ */
+static inline uint32_t intern_id(const char* interned) {
+    return intern_entry(interned)->id;
+}
+
+/**
+ * @brief Get hash of interned string (computed only once, when interned)
+ */
+static inline uint32_t intern_hash(const char* interned) {
+    return intern_entry(interned)->hash;
+}
+
+/**
+ * @brief Get length of interned string
+ */
+static inline size_t intern_len(const char* interned) {
+    return intern_entry(interned)->len;
+}
+
+/**
+ * @brief Get number of distinct interned strings
+ *
+ * @return Number of strings
+ */
+size_t intern_count();
+
+/**
+ * @brief Print pool statistics (lookups, hit rate, memory)
+ *
+ * @param out Output stream
+ */
+void intern_print_stats(FILE* out);
+
+/**
+ * @brief Free all interned strings (all interned pointers become invalid)
+ */
+void intern_free();
+
+#endif  // __INTERN_H__
@@ -0,0 +1,354 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file ir.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Instruction representation of IFJcode22
+ */
+
+#include "ir.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "intern.h"
+
+#define INIT_SIZE 64
+
+static const char* ir_names[IR_OPCODE_COUNT] = {
+    [IR_MOVE] = "MOVE",
+    [IR_CREATEFRAME] = "CREATEFRAME",
+    [IR_PUSHFRAME] = "PUSHFRAME",
+    [IR_POPFRAME] = "POPFRAME",
+    [IR_DEFVAR] = "DEFVAR",
+    [IR_CALL] = "CALL",
+    [IR_RETURN] = "RETURN",
+    [IR_PUSHS] = "PUSHS",
+    [IR_POPS] = "POPS",
+    [IR_CLEARS] = "CLEARS",
+    [IR_ADD] = "ADD",
+    [IR_SUB] = "SUB",
+    [IR_MUL] = "MUL",
+    [IR_DIV] = "DIV",
+    [IR_IDIV] = "IDIV",
+    [IR_ADDS] = "ADDS",
+    [IR_SUBS] = "SUBS",
+    [IR_MULS] = "MULS",
+    [IR_DIVS] = "DIVS",
+    [IR_IDIVS] = "IDIVS",
+    [IR_LT] = "LT",
+    [IR_GT] = "GT",
+    [IR_EQ] = "EQ",
+    [IR_LTS] = "LTS",
+    [IR_GTS] = "GTS",
+    [IR_EQS] = "EQS",
+    [IR_AND] = "AND",
+    [IR_OR] = "OR",
+    [IR_NOT] = "NOT",
+    [IR_ANDS] = "ANDS",
+    [IR_ORS] = "ORS",
+    [IR_NOTS] = "NOTS",
+    [IR_INT2FLOAT] = "INT2FLOAT",
+    [IR_FLOAT2INT] = "FLOAT2INT",
+    [IR_INT2CHAR] = "INT2CHAR",
+    [IR_STRI2INT] = "STRI2INT",
+    [IR_INT2FLOATS] = "INT2FLOATS",
+    [IR_FLOAT2INTS] = "FLOAT2INTS",
+    [IR_INT2CHARS] = "INT2CHARS",
+    [IR_STRI2INTS] = "STRI2INTS",
+    [IR_READ] = "READ",
+    [IR_WRITE] = "WRITE",
+    [IR_CONCAT] = "CONCAT",
+    [IR_STRLEN] = "STRLEN",
+    [IR_GETCHAR] = "GETCHAR",
+    [IR_SETCHAR] = "SETCHAR",
+    [IR_TYPE] = "TYPE",
+    [IR_LABEL] = "LABEL",
+    [IR_JUMP] = "JUMP",
+    [IR_JUMPIFEQ] = "JUMPIFEQ",
+    [IR_JUMPIFNEQ] = "JUMPIFNEQ",
+    [IR_JUMPIFEQS] = "JUMPIFEQS",
+    [IR_JUMPIFNEQS] = "JUMPIFNEQS",
+    [IR_EXIT] = "EXIT",
+    [IR_BREAK] = "BREAK",
+    [IR_DPRINT] = "DPRINT",
+    [IR_HEADER] = ".IFJcode22",
+};
+
+static const char* ir_frames[] = {
+    [IR_GF] = "GF@",
+    [IR_LF] = "LF@",
+    [IR_TF] = "TF@",
+};
+
+ir_code_t ir_code_new() {
+    return (ir_code_t){.items = NULL, .len = 0, .size = 0};
+}
+
+void ir_code_free(ir_code_t* code) {
+    free(code->items);
+    *code = ir_code_new();
+}
+
+void ir_code_clear(ir_code_t* code) {
+    code->len = 0;
+}
+
+/**
+ * @brief Make space for at least n more instructions
+ *
+ * @param code Code
+ * @param n Number of instructions
+ */
+static void ir_code_reserve(ir_code_t* code, size_t n) {
+    if (code->len + n <= code->size) {
+        return;
+    }
+    size_t size = code->size == 0 ? INIT_SIZE : code->size * 2;
+    while (size < code->len + n) {
+        size *= 2;
+    }
+    ir_instr_t* items = realloc(code->items, size * sizeof(ir_instr_t));
+    if (items == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    code->items = items;
+    code->size = size;
+}
+
+void ir_code_grow(ir_code_t* code) {
+    ir_code_reserve(code, 1);
+}
+
+void ir_code_splice(ir_code_t* code, ir_code_t* src) {
+    if (code->len == 0) {
+        // Nothing to keep, vectors are just swapped
+        ir_code_t tmp = *code;
+        *code = *src;
+        *src = tmp;
+        return;
+    }
+    ir_code_reserve(code, src->len);
+    memcpy(code->items + code->len, src->items, src->len * sizeof(ir_instr_t));
+    code->len += src->len;
+    ir_code_clear(src);
+}
+
+/**
+ * @brief Find opcode by its name
+ *
+ * @param name Name (not null terminated)
+ * @param len Length of name
+ * @return Opcode
+ */
+static ir_opcode_t ir_asm_opcode(const char* name, size_t len) {
+    for (int op = 0; op < IR_OPCODE_COUNT; op++) {
+        if (strlen(ir_names[op]) == len && memcmp(ir_names[op], name, len) == 0) {
+            return op;
+        }
+    }
+    error_exit(ERR_INTERNAL);
+    return IR_OPCODE_COUNT;
+}
+
+/**
+ * @brief Parse one operand of constant text
+ *
+ * @param op Opcode of instruction (decides between label and type operands)
+ * @param index Index of operand
+ * @param text Operand text (not null terminated)
+ * @param len Length of operand text
+ * @return Parsed operand
+ */
+static ir_operand_t ir_asm_operand(ir_opcode_t op, int index, const char* text, size_t len) {
+    const char* at = memchr(text, '@', len);
+    if (at == NULL) {
+        if (op == IR_READ && index == 1) {
+            return ir_type(intern(text, len));
+        }
+        return ir_label(intern(text, len), -1);
+    }
+
+    const size_t prefix = at - text;
+    const char* val = at + 1;
+    const size_t val_len = len - prefix - 1;
+    for (int frame = IR_GF; frame <= IR_TF; frame++) {
+        if (prefix == 2 && memcmp(text, ir_frames[frame], 2) == 0) {
+            return ir_var(frame, intern(val, val_len));
+        }
+    }
+    // Literals are parsed from a null terminated copy
+    char buf[256];
+    if (val_len >= sizeof(buf)) {
+        error_exit(ERR_INTERNAL);
+    }
+    memcpy(buf, val, val_len);
+    buf[val_len] = '\0';
+    if (strncmp(text, "int@", 4) == 0) {
+        return ir_int(strtoll(buf, NULL, 10));
+    } else if (strncmp(text, "float@", 6) == 0) {
+        return ir_float(strtod(buf, NULL));
+    } else if (strncmp(text, "bool@", 5) == 0) {
+        return ir_bool(strcmp(buf, "true") == 0);
+    } else if (strncmp(text, "nil@", 4) == 0) {
+        return ir_nil();
+    } else if (strncmp(text, "string@", 7) == 0) {
+        // Escape sequences are decoded in place (decoded text is never longer)
+        size_t n = 0;
+        for (size_t i = 0; i < val_len; i++) {
+            if (buf[i] == '\\' && i + 3 < val_len) {
+                buf[n++] = (char)((buf[i + 1] - '0') * 100 + (buf[i + 2] - '0') * 10 +
+                                  (buf[i + 3] - '0'));
+                i += 3;
+            } else {
+                buf[n++] = buf[i];
+            }
+        }
+        const char* interned = intern(buf, n);
+        return ir_string(interned, n);
+    }
+    error_exit(ERR_INTERNAL);
+    return ir_nil();
+}
+
+void ir_add_asm(ir_code_t* code, const char* text) {
+    while (*text != '\0') {
+        const char* end = strchr(text, '\n');
+        if (end == NULL) {
+            end = text + strlen(text);
+        }
+        // Split line into opcode and operands
+        const char* parts[4];
+        size_t lens[4];
+        int count = 0;
+        const char* p = text;
+        while (p < end) {
+            const char* space = memchr(p, ' ', end - p);
+            const char* part_end = space == NULL ? end : space;
+            if (count == 4) {
+                error_exit(ERR_INTERNAL);
+            }
+            parts[count] = p;
+            lens[count++] = part_end - p;
+            p = space == NULL ? end : space + 1;
+        }
+        if (count > 0) {
+            ir_opcode_t op = ir_asm_opcode(parts[0], lens[0]);
+            ir_operand_t args[3];
+            memset(args, 0, sizeof(args));
+            for (int i = 1; i < count; i++) {
+                args[i - 1] = ir_asm_operand(op, i - 1, parts[i], lens[i]);
+            }
+            ir_add3(code, op, args[0], args[1], args[2]);
+        }
+        text = *end == '\0' ? end : end + 1;
+    }
+}
+
+/**
+ * @brief Print n characters
+ *
+ * @param rope Destination rope
+ * @param str Characters
+ * @param n Number of characters
+ */
+static inline void ir_put(rope_t* rope, const char* str, size_t n) {
+    // Most pieces fit to the last chunk
+    rope_chunk_t* tail = rope->tail;
+    if (tail != NULL && tail->size - tail->len >= n) {
+        memcpy(tail->data + tail->len, str, n);
+        tail->len += n;
+        rope->len += n;
+    } else {
+        rope_add_cstr_n(rope, str, n);
+    }
+}
+
+/**
+ * @brief Print one character
+ *
+ * @param rope Destination rope
+ * @param c Character
+ */
+static inline void ir_put_char(rope_t* rope, char c) {
+    ir_put(rope, &c, 1);
+}
+
+/**
+ * @brief Print one operand
+ *
+ * @param rope Destination rope
+ * @param arg Operand
+ */
+static void ir_print_operand(rope_t* rope, ir_operand_t* arg) {
+    char buf[32];
+    switch (arg->kind) {
+        case IR_VAR:
+            ir_put(rope, ir_frames[arg->frame], 3);
+            ir_put(rope, arg->name, strlen(arg->name));
+            break;
+        case IR_INT:
+            ir_put(rope, "int@", 4);
+            ir_put(rope, buf, sprintf(buf, "%" PRId64, arg->val_i));
+            break;
+        case IR_FLOAT:
+            ir_put(rope, "float@", 6);
+            ir_put(rope, buf, sprintf(buf, "%a", arg->val_f));
+            break;
+        case IR_STRING:
+            ir_put(rope, "string@", 7);
+            for (int32_t i = 0; i < arg->id; i++) {
+                char c = arg->name[i];
+                // These ASCII codes have to be represented with escape sequences
+                if ((c >= 0 && c <= 32) || c == 35 || c == 92) {
+                    ir_put(rope, buf, sprintf(buf, "\\%03d", c));
+                } else {
+                    ir_put_char(rope, c);
+                }
+            }
+            break;
+        case IR_BOOL:
+            if (arg->val_b) {
+                ir_put(rope, "bool@true", 9);
+            } else {
+                ir_put(rope, "bool@false", 10);
+            }
+            break;
+        case IR_NIL:
+            ir_put(rope, "nil@nil", 7);
+            break;
+        case IR_LABELID:
+            ir_put(rope, arg->name, strlen(arg->name));
+            if (arg->id >= 0) {
+                ir_put(rope, buf, sprintf(buf, "%d", (int)arg->id));
+            }
+            break;
+        case IR_TYPEID:
+            ir_put(rope, arg->name, strlen(arg->name));
+            break;
+        default:
+            error_exit(ERR_INTERNAL);
+    }
+}
+
+void ir_code_print(ir_code_t* code, rope_t* rope) {
+    for (size_t i = 0; i < code->len; i++) {
+        ir_instr_t* instr = &code->items[i];
+        ir_put(rope, ir_names[instr->op], strlen(ir_names[instr->op]));
+        for (int j = 0; j < 3 && instr->args[j].kind != IR_NONE; j++) {
+            ir_put_char(rope, ' ');
+            ir_print_operand(rope, &instr->args[j]);
+        }
+        ir_put_char(rope, '\n');
+    }
+}
+
+void ir_code_write(ir_code_t* code, FILE* file) {
+    rope_t rope = rope_new();
+    ir_code_print(code, &rope);
+    rope_write(&rope, file);
+    rope_free(&rope);
+}
@@ -0,0 +1,344 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file ir.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Instruction representation of IFJcode22 (built by generator, printed to ropes)
+ *
+ * Code is a vector of instructions with typed operands. Names of variables, labels and string
+ * literals are not copied, they have to live as long as the code (interned strings or literals).
+ */
+
+#ifndef __IR_H__
+#define __IR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "rope.h"
+
+typedef enum {
+    // Frames, function calls
+    IR_MOVE,
+    IR_CREATEFRAME,
+    IR_PUSHFRAME,
+    IR_POPFRAME,
+    IR_DEFVAR,
+    IR_CALL,
+    IR_RETURN,
+    // Data stack
+    IR_PUSHS,
+    IR_POPS,
+    IR_CLEARS,
+    // Arithmetic, relational, boolean and conversion
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_IDIV,
+    IR_ADDS,
+    IR_SUBS,
+    IR_MULS,
+    IR_DIVS,
+    IR_IDIVS,
+    IR_LT,
+    IR_GT,
+    IR_EQ,
+    IR_LTS,
+    IR_GTS,
+    IR_EQS,
+    IR_AND,
+    IR_OR,
+    IR_NOT,
+    IR_ANDS,
+    IR_ORS,
+    IR_NOTS,
+    IR_INT2FLOAT,
+    IR_FLOAT2INT,
+    IR_INT2CHAR,
+    IR_STRI2INT,
+    IR_INT2FLOATS,
+    IR_FLOAT2INTS,
+    IR_INT2CHARS,
+    IR_STRI2INTS,
+    // Input, output
+    IR_READ,
+    IR_WRITE,
+    // Strings
+    IR_CONCAT,
+    IR_STRLEN,
+    IR_GETCHAR,
+    IR_SETCHAR,
+    // Types
+    IR_TYPE,
+    // Control flow
+    IR_LABEL,
+    IR_JUMP,
+    IR_JUMPIFEQ,
+    IR_JUMPIFNEQ,
+    IR_JUMPIFEQS,
+    IR_JUMPIFNEQS,
+    IR_EXIT,
+    // Debugging
+    IR_BREAK,
+    IR_DPRINT,
+    // Program header (.IFJcode22)
+    IR_HEADER,
+    IR_OPCODE_COUNT,
+} ir_opcode_t;
+
+typedef enum {
+    IR_NONE,     // No operand
+    IR_VAR,      // Variable (frame + name)
+    IR_INT,      // Integer literal
+    IR_FLOAT,    // Float literal
+    IR_STRING,   // String literal (name + length in id, escaped when printed)
+    IR_BOOL,     // Bool literal
+    IR_NIL,      // Nil literal
+    IR_LABELID,  // Label (name + id, id is printed only if it isn't negative)
+    IR_TYPEID,   // Type name (read instruction)
+} ir_kind_t;
+
+typedef enum {
+    IR_GF,  // Global frame
+    IR_LF,  // Local frame
+    IR_TF,  // Temporary frame
+} ir_frame_t;
+
+typedef struct {
+    union {
+        int64_t val_i;
+        double val_f;
+        bool val_b;
+        const char* name;
+    };
+    int32_t id;     // Label id / length of string literal
+    uint8_t kind;   // ir_kind_t
+    uint8_t frame;  // ir_frame_t (variables only)
+} ir_operand_t;
+
+typedef struct {
+    uint8_t op;  // ir_opcode_t
+    ir_operand_t args[3];
+} ir_instr_t;
+
+typedef struct {
+    ir_instr_t* items;  // Instructions
+    size_t len;         // Number of instructions
+    size_t size;        // Capacity
+} ir_code_t;
+
+/**
+ * @brief Missing operand
+ */
+static inline ir_operand_t ir_none() {
+    ir_operand_t arg;
+    memset(&arg, 0, sizeof(arg));
+    return arg;
+}
+
+/**
+ * @brief Variable operand
+ *
+ * @param frame Frame
+ * @param name Name of variable (without frame)
+ */
+static inline ir_operand_t ir_var(ir_frame_t frame, const char* name) {
+    ir_operand_t arg = ir_none();
+    arg.name = name;
+    arg.kind = IR_VAR;
+    arg.frame = frame;
+    return arg;
+}
+
+/**
+ * @brief Integer literal operand
+ */
+static inline ir_operand_t ir_int(int64_t val) {
+    ir_operand_t arg = ir_none();
+    arg.val_i = val;
+    arg.kind = IR_INT;
+    return arg;
+}
+
+/**
+ * @brief Float literal operand
+ */
+static inline ir_operand_t ir_float(double val) {
+    ir_operand_t arg = ir_none();
+    arg.val_f = val;
+    arg.kind = IR_FLOAT;
+    return arg;
+}
+
+/**
+ * @brief String literal operand
+ *
+ * @param val Characters (unescaped, don't have to be null terminated)
+ * @param len Number of characters
+ */
+static inline ir_operand_t ir_string(const char* val, size_t len) {
+    ir_operand_t arg = ir_none();
+    arg.name = val;
+    arg.id = (int32_t)len;
+    arg.kind = IR_STRING;
+    return arg;
+}
+
+/**
+ * @brief Bool literal operand
+ */
+static inline ir_operand_t ir_bool(bool val) {
+    ir_operand_t arg = ir_none();
+    arg.val_b = val;
+    arg.kind = IR_BOOL;
+    return arg;
+}
+
+/**
+ * @brief Nil literal operand
+ */
+static inline ir_operand_t ir_nil() {
+    ir_operand_t arg = ir_none();
+    arg.kind = IR_NIL;
+    return arg;
+}
+
+/**
+ * @brief Label operand (e.g. name "!loop_" with id 3 is !loop_3)
+ *
+ * @param name Name of label
+ * @param id Numeric suffix (-1 for none)
+ */
+static inline ir_operand_t ir_label(const char* name, int id) {
+    ir_operand_t arg = ir_none();
+    arg.name = name;
+    arg.id = id;
+    arg.kind = IR_LABELID;
+    return arg;
+}
+
+/**
+ * @brief Type operand (int, float, string, bool)
+ */
+static inline ir_operand_t ir_type(const char* name) {
+    ir_operand_t arg = ir_none();
+    arg.name = name;
+    arg.kind = IR_TYPEID;
+    return arg;
+}
+
+/**
+ * @brief Initialize new empty code (nothing is allocated until first instruction)
+ *
+ * @return Empty code
+ */
+ir_code_t ir_code_new();
+
+/**
+ * @brief Free instructions of code
+ *
+ * @param code Code
+ */
+void ir_code_free(ir_code_t* code);
+
+/**
+ * @brief Remove all instructions (memory is kept for reuse)
+ *
+ * @param code Code
+ */
+void ir_code_clear(ir_code_t* code);
+
+/**
+ * @brief Make space for at least one more instruction (grows capacity)
+ *
+ * @param code Code
+ */
+void ir_code_grow(ir_code_t* code);
+
+/**
+ * @brief Append instruction with up to three operands (unused ones are IR_NONE)
+ *
+ * @param code Destination code
+ * @param op Opcode
+ * @param a First operand
+ * @param b Second operand
+ * @param c Third operand
+ */
+static inline void ir_add3(ir_code_t* code,
+                           ir_opcode_t op,
+                           ir_operand_t a,
+                           ir_operand_t b,
+                           ir_operand_t c) {
+    if (code->len == code->size) {
+        ir_code_grow(code);
+    }
+    ir_instr_t* instr = &code->items[code->len++];
+    instr->op = op;
+    instr->args[0] = a;
+    instr->args[1] = b;
+    instr->args[2] = c;
+}
+
+/**
+ * @brief Append instruction without operands
+ */
+static inline void ir_add(ir_code_t* code, ir_opcode_t op) {
+    ir_add3(code, op, ir_none(), ir_none(), ir_none());
+}
+
+/**
+ * @brief Append instruction with one operand
+ */
+static inline void ir_add1(ir_code_t* code, ir_opcode_t op, ir_operand_t a) {
+    ir_add3(code, op, a, ir_none(), ir_none());
+}
+
+/**
+ * @brief Append instruction with two operands
+ */
+static inline void ir_add2(ir_code_t* code, ir_opcode_t op, ir_operand_t a, ir_operand_t b) {
+    ir_add3(code, op, a, b, ir_none());
+}
+
+/**
+ * @brief Append constant IFJcode22 text (one instruction per line), used for buildin functions
+ *
+ * Names are interned, so the text doesn't have to outlive the code. Invalid text is internal
+ * error.
+ *
+ * @param code Destination code
+ * @param text IFJcode22 text
+ */
+void ir_add_asm(ir_code_t* code, const char* text);
+
+/**
+ * @brief Move all instructions of one code to the end of another one
+ *
+ * @param code Destination code
+ * @param src Source code (empty afterwards)
+ */
+void ir_code_splice(ir_code_t* code, ir_code_t* src);
+
+/**
+ * @brief Print code as IFJcode22 text to the end of rope
+ *
+ * @param code Code
+ * @param rope Destination rope
+ */
+void ir_code_print(ir_code_t* code, rope_t* rope);
+
+/**
+ * @brief Print code as IFJcode22 text to file
+ *
+ * @param code Code
+ * @param file Output
+ */
+void ir_code_write(ir_code_t* code, FILE* file);
+
+#endif  // __IR_H__
@@ -0,0 +1,52 @@
+// Generated by tools/gen_keywords from token.h, do not edit
+
+#ifndef __KEYWORDS_H__
+#define __KEYWORDS_H__
+
+#include <string.h>
+#include "token.h"
+
+#define KEYWORD_MIN_LEN 2
+#define KEYWORD_MAX_LEN 8
+
+// Hash table indexed by (len + first * 1 + last * 7) & 31
+static const struct {
+    const char* name;
+    size_t len;
+    token_type_t type;
+} keyword_table[32] = {
+    [6] = {"null", 4, TOK_NULL},
+    [12] = {"else", 4, TOK_ELSE},
+    [23] = {"float", 5, TOK_FLOAT},
+    [16] = {"function", 8, TOK_FUNCTION},
+    [21] = {"if", 2, TOK_IF},
+    [24] = {"int", 3, TOK_INT},
+    [26] = {"return", 6, TOK_RETURN},
+    [10] = {"string", 6, TOK_STRING},
+    [22] = {"void", 4, TOK_VOID},
+    [31] = {"while", 5, TOK_WHILE},
+    [7] = {"for", 3, TOK_FOR},
+    [20] = {"break", 5, TOK_BREAK},
+    [14] = {"continue", 8, TOK_CONTINUE},
+};
+
+/**
+ * @brief Find keyword token type
+ *
+ * @param str Identifier (doesn't have to be null terminated)
+ * @param len Identifier length
+ * @return Keyword token type or -1 if identifier is not keyword
+ */
+static inline int keyword_lookup(const char* str, size_t len) {
+    if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN) {
+        return -1;
+    }
+    unsigned h = (len + (unsigned char)str[0] * 1u +
+                  (unsigned char)str[len - 1] * 7u) & 31u;
+    if (keyword_table[h].len != len || memcmp(keyword_table[h].name, str, len) != 0) {
+        return -1;
+    }
+    return keyword_table[h].type;
+}
+
+#endif  // __KEYWORDS_H__
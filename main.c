@@ -9,20 +9,57 @@
  * @brief Entry point of IFJ22 compiler
  */
 
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "error.h"
 #include "gen.h"
+#include "intern.h"
 #include "parser.h"
 #include "scanner.h"
+#include "scanner_parallel.h"
+
+int main(int argc, char** argv) {
+    // Optional -j N lexes whole input with N threads before parsing (for very large sources)
+    unsigned long threads = 1;
+    // Optional -s writes code as soon as it is generated (memory doesn't grow with the program)
+    bool streaming = false;
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            char* end;
+            threads = strtoul(argv[++i], &end, 10);
+            usage |= *end != '\0' || threads == 0;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            streaming = true;
+        } else {
+            usage = true;
+        }
+    }
+    if (usage) {
+        fprintf(stderr, "usage: %s [-j threads] [-s] < input.php\n", argv[0]);
+        return ERR_INTERNAL;
+    }
 
-int main() {
     scanner_t scanner = scanner_new(stdin);
-    gen_t gen = gen_new();
-    parser_t parser = parser_new(&scanner, &gen);
+    gen_t gen = streaming ? gen_new_streaming(stdout) : gen_new();
+    parser_t parser;
+    if (threads > 1) {
+        size_t count;
+        token_t* tokens = scanner_lex_parallel(&scanner, threads, &count);
+        parser = parser_new_from_tokens(&scanner, tokens, count, &gen);
+    } else {
+        parser = parser_new(&scanner, &gen);
+    }
     parser_run(&parser);
     gen_emit(&gen);
     parser_free(&parser);
     gen_free(&gen);
     scanner_free(&scanner);
+#ifdef DEBUG_STATS
+    intern_print_stats(stderr);
+#endif  // DEBUG_STATS
+    intern_free();
     return RET_OK;
 }
@@ -0,0 +1,157 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file number.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Conversion of numeric literals (Clinger fast path, Eisel-Lemire, strtod as fallback)
+ */
+
+#include "number.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error.h"
+#include "pow5.h"
+
+// Binary64 layout
+#define MANTISSA_BITS 52
+#define MINIMUM_EXPONENT (-1023)
+#define INFINITE_POWER 0x7FF
+
+bool number_to_int(number_t* number, int64_t* value) {
+    if (number->exponent > 0 || number->mantissa > INT64_MAX) {
+        return false;
+    }
+    *value = (int64_t)number->mantissa;
+    return true;
+}
+
+/**
+ * @brief Full 64x64 -> 128 bit multiplication
+ */
+static inline void mul_128(uint64_t a, uint64_t b, uint64_t* high, uint64_t* low) {
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    *low = (cross << 32) | (uint32_t)lo_lo;
+}
+
+/**
+ * @brief Eisel-Lemire algorithm, 128-bit product is always enough for exact mantissa
+ * (proved by N. Mushtak and D. Lemire, "Fast Number Parsing Without Fallback")
+ *
+ * @param q Decimal exponent (in range of the power table)
+ * @param w Decimal mantissa (nonzero)
+ * @return Bits of correctly rounded double
+ */
+static uint64_t eisel_lemire(int64_t q, uint64_t w) {
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+
+    // Product with 5^q, second half of the power is needed only if the first one is inconclusive
+    const uint64_t* power = &pow5_128[2 * (q - POW5_MIN_EXP)];
+    uint64_t high, low;
+    mul_128(w, power[0], &high, &low);
+    const uint64_t precision_mask = UINT64_MAX >> (MANTISSA_BITS + 3);
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t high2, low2;
+        mul_128(w, power[1], &high2, &low2);
+        low += high2;
+        high += high2 > low;
+    }
+
+    int upperbit = high >> 63;
+    int shift = upperbit + 64 - MANTISSA_BITS - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(q * log2(10)) + 63
+    int64_t power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - MINIMUM_EXPONENT;
+
+    if (power2 <= 0) {
+        // Subnormal number
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < (UINT64_C(1) << MANTISSA_BITS) ? 0 : 1;
+        return (mantissa & ~(UINT64_C(1) << MANTISSA_BITS)) | ((uint64_t)power2 << MANTISSA_BITS);
+    }
+
+    // Exactly halfway between two doubles has to be rounded to even
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+        mantissa &= ~UINT64_C(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (UINT64_C(2) << MANTISSA_BITS)) {
+        mantissa = UINT64_C(1) << MANTISSA_BITS;
+        power2++;
+    }
+    mantissa &= ~(UINT64_C(1) << MANTISSA_BITS);
+    if (power2 >= INFINITE_POWER) {
+        return (uint64_t)INFINITE_POWER << MANTISSA_BITS;
+    }
+    return mantissa | ((uint64_t)power2 << MANTISSA_BITS);
+}
+
+/**
+ * @brief Exact slow path (only for literals with more than NUMBER_MAX_DIGITS digits)
+ */
+static double number_slow_path(const char* text, size_t len) {
+    char* copy = malloc(len + 1);
+    if (copy == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    double value = strtod(copy, NULL);
+    free(copy);
+    return value;
+}
+
+double number_to_double(number_t* number, const char* text, size_t len) {
+    const int64_t q =
+        number->exponent + (number->exp_negative ? -number->exp_value : number->exp_value);
+    const uint64_t w = number->mantissa;
+    if (w == 0) {
+        return 0.0;
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Powers of ten which are exactly representable as double
+    static const double exact_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                         1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                         1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    // Clinger: both operands are exact, so the only rounding is the one of the operation
+    if (!number->truncated && q >= -22 && q <= 22 && w <= UINT64_C(1) << 53) {
+        return q < 0 ? (double)w / exact_pow10[-q] : (double)w * exact_pow10[q];
+    }
+#endif
+
+    // Even the biggest mantissa would be rounded to zero / infinity
+    if (q < POW5_MIN_EXP) {
+        return 0.0;
+    }
+    if (q > POW5_MAX_EXP) {
+        return INFINITY;
+    }
+
+    uint64_t bits = eisel_lemire(q, w);
+    // Dropped digits are somewhere between w and w + 1, both have to give the same result
+    if (number->truncated && eisel_lemire(q, w + 1) != bits) {
+        return number_slow_path(text, len);
+    }
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
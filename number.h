@@ -0,0 +1,112 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file number.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for conversion of numeric literals
+ *
+ * Scanner accumulates value of the literal digit by digit, so the text is never scanned again
+ * (except for rare floats which need the exact slow path).
+ */
+
+#ifndef __NUMBER_H__
+#define __NUMBER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum number of significant digits kept in mantissa (10^19 < 2^64)
+#define NUMBER_MAX_DIGITS 19
+// Explicit exponent is saturated (anything bigger is infinity or zero anyway)
+#define NUMBER_MAX_EXPONENT 100000
+
+/**
+ * @brief Numeric literal being scanned (value is mantissa * 10^(exponent +- exp_value))
+ */
+typedef struct {
+    uint64_t mantissa;  // First NUMBER_MAX_DIGITS significant digits
+    int64_t exponent;   // Decimal exponent from decimal point and dropped digits
+    int64_t exp_value;  // Explicit exponent (after e)
+    int digits;         // Number of significant digits in mantissa
+    bool exp_negative;  // Is explicit exponent negative?
+    bool truncated;     // Were some nonzero digits dropped?
+} number_t;
+
+/**
+ * @brief Initialize empty literal
+ *
+ * @return Literal with value 0
+ */
+static inline number_t number_new() {
+    return (number_t){0};
+}
+
+/**
+ * @brief Add digit before decimal point
+ *
+ * @param number Literal
+ * @param c Digit character
+ */
+static inline void number_add_digit(number_t* number, int c) {
+    if (number->digits < NUMBER_MAX_DIGITS) {
+        number->mantissa = number->mantissa * 10 + (c - '0');
+        // Leading zeros are not significant
+        number->digits += number->mantissa != 0;
+    } else {
+        number->truncated |= c != '0';
+        number->exponent++;
+    }
+}
+
+/**
+ * @brief Add digit after decimal point
+ *
+ * @param number Literal
+ * @param c Digit character
+ */
+static inline void number_add_fraction_digit(number_t* number, int c) {
+    if (number->digits < NUMBER_MAX_DIGITS) {
+        number->mantissa = number->mantissa * 10 + (c - '0');
+        number->digits += number->mantissa != 0;
+        number->exponent--;
+    } else {
+        number->truncated |= c != '0';
+    }
+}
+
+/**
+ * @brief Add digit of explicit exponent
+ *
+ * @param number Literal
+ * @param c Digit character
+ */
+static inline void number_add_exponent_digit(number_t* number, int c) {
+    if (number->exp_value < NUMBER_MAX_EXPONENT) {
+        number->exp_value = number->exp_value * 10 + (c - '0');
+    }
+}
+
+/**
+ * @brief Get value of integer literal
+ *
+ * @param number Literal without decimal point and exponent
+ * @param value Output value
+ * @return false if the value doesn't fit into int64_t
+ */
+bool number_to_int(number_t* number, int64_t* value);
+
+/**
+ * @brief Get value of literal as double (correctly rounded, same as strtod)
+ *
+ * @param number Literal
+ * @param text Text of the literal (used only by the slow path, doesn't have to be null terminated)
+ * @param len Length of the text
+ * @return Value
+ */
+double number_to_double(number_t* number, const char* text, size_t len);
+
+#endif  // __NUMBER_H__
@@ -11,32 +11,42 @@
 
 #include "parser.h"
 #include <stdio.h>
+#include <string.h>
 #include "error.h"
 #include "exp.h"
 
+/**
+ * @brief Take next token from the queue, lexical errors are reported when they are reached
+ *
+ * @param parser Parser instance
+ */
+static inline void take_token(parser_t* parser) {
+    parser->token = token_queue_advance(&parser->queue);
+    if (parser->token.type == TOK_ERROR) {
+        error_exit(parser->token.attr.val_i);
+    }
+}
+
 void next_token_keep(parser_t* parser) {
     parser->last_default = false;
-    if (parser->buffer_token_valid) {
-        parser->buffer_token_valid = false;
-        parser->token = parser->buffer_token;
-    } else {
-        parser->token = scanner_get_next(parser->scanner);
-    }
+    take_token(parser);
 #ifdef DEBUG_TOK
-    token_print(&parser->token);
+    token_print(&parser->token, parser->source);
 #endif  // DEBUG_TOK
 }
 
+token_t* peek_token(parser_t* parser, size_t k) {
+    return token_queue_peek(&parser->queue, k - 1);
+}
+
 /**
  * @brief Get next token from scanner and save it into parser instance
- * Frees the previous token
  *
  * @param parser Parser instance
  */
 void next_token(parser_t* parser) {
-    token_free(&parser->token);
     parser->last_default = false;
-    parser->token = scanner_get_next(parser->scanner);
+    take_token(parser);
 }
 
 /**
@@ -83,7 +93,7 @@ void token_check_type(parser_t* parser, token_type_t type) {
     if (!token_is_type(parser, type)) {
 #ifdef DEBUG_TOK
         printf("Expected token_type: %s, gotten:\n", token_to_string(type));
-        token_print(&parser->token);
+        token_print(&parser->token, parser->source);
 #endif  // DEBUG_TOK
         error_exit(ERR_SYN);
     }
@@ -131,14 +141,25 @@ void parser_var_to_symtable(parser_t* parser, parser_state_t state) {
     }
 }
 
-parser_t parser_new(scanner_t* scanner, gen_t* gen) {
-    parser_t parser = {.scanner = scanner,
+/**
+ * @brief Initialize parser reading tokens from the queue
+ *
+ * @param queue Token queue
+ * @param source Source of the tokens (for locations)
+ * @param gen Generator instance
+ * @return Initialized parser
+ */
+static parser_t parser_new_from_queue(token_queue_t queue, source_t* source, gen_t* gen) {
+    parser_t parser = {.queue = queue,
+                       .source = source,
                        .gen = gen,
-                       .local_symtable = htab_new(),
-                       .global_symtable = htab_new(),
-                       .buffer_token_valid = false,
+                       .global_arena = arena_new(),
+                       .function_arena = arena_new(),
+                       .exp_arena = arena_new(),
                        .last_default = false,
                        .param_count = 0};
+    parser.local_symtable = htab_new(parser.function_arena);
+    parser.global_symtable = htab_new(parser.global_arena);
 
     // Define buildin functions
     htab_define_buildin(parser.global_symtable);
@@ -146,16 +167,29 @@ parser_t parser_new(scanner_t* scanner, gen_t* gen) {
     return parser;
 }
 
+parser_t parser_new(scanner_t* scanner, gen_t* gen) {
+    return parser_new_from_queue(token_queue_new(scanner), &scanner->source, gen);
+}
+
+parser_t parser_new_from_tokens(scanner_t* scanner, token_t* tokens, size_t count, gen_t* gen) {
+    return parser_new_from_queue(token_queue_new_from_tokens(tokens, count), &scanner->source, gen);
+}
+
 void parser_free(parser_t* parser) {
+    token_queue_free(&parser->queue);
     htab_free(parser->local_symtable);
     htab_free(parser->global_symtable);
+    arena_free(parser->exp_arena);
+    arena_free(parser->function_arena);
+    arena_free(parser->global_arena);
 }
 
 void rule_additional_param(parser_t* parser, parser_state_t state) {
     (void)state;
     if (next_token_is_type(parser, TOK_COMMA)) {                         // ,
         next_token_check_by_function(parser, token_is_datatype);         // type
-        htab_function_add_param(parser->function, &parser->token);       //
+        htab_function_add_param(parser->global_symtable,                 //
+                                parser->function, &parser->token);       //
         next_token_check_type(parser, TOK_VAR);                          // $var
         htab_function_add_param_name(parser->function, &parser->token);  //
         htab_add_variable(parser->local_symtable, &parser->token);       //
@@ -167,7 +201,8 @@ void rule_param(parser_t* parser, parser_state_t state) {
     (void)state;
     next_token(parser);
     if (token_is_datatype(&parser->token)) {                             // type
-        htab_function_add_param(parser->function, &parser->token);       //
+        htab_function_add_param(parser->global_symtable,                 //
+                                parser->function, &parser->token);       //
         next_token_check_type(parser, TOK_VAR);                          // $var
         htab_function_add_param_name(parser->function, &parser->token);  //
         htab_add_variable(parser->local_symtable, &parser->token);       //
@@ -218,7 +253,7 @@ void rule_function_call(parser_t* parser, parser_state_t state) {
     next_token_check_type(parser, TOK_SEMICOLON);  // ;
     htab_function_check_params(parser->function_call, parser->param_count, false);
     parser->param_count = 0;
-    gen_function_call(parser->gen, state.in_function);
+    gen_function_call(parser->gen, &parser->function_call->value.function, state.in_function);
 }
 
 void rule_value(parser_t* parser, parser_state_t state) {
@@ -238,7 +273,7 @@ void rule_exp_for(parser_t* parser, parser_state_t state) {
     } else {
         token_check_type(parser, TOK_VAR);                               // $var
         str_clear(&parser->gen->variable);                               //
-        str_add_str(&parser->gen->variable, &parser->token.attr.val_s);  //
+        str_add_cstr(&parser->gen->variable, parser->token.attr.val_s);  //
         parser_var_to_symtable(parser, state);                           //
         next_token_check_type(parser, TOK_ASSIGN);                       // =
         next_token(parser);                                              //
@@ -250,27 +285,19 @@ void rule_statement(parser_t* parser, parser_state_t state) {
     (void)state;
     switch (parser->token.type) {
         case TOK_VAR: {                                                      // $var
-            token_t tmp = parser->token;                                     //
             str_clear(&parser->gen->variable);                               //
-            str_add_str(&parser->gen->variable, &parser->token.attr.val_s);  //
+            str_add_cstr(&parser->gen->variable, parser->token.attr.val_s);  //
             parser_var_to_symtable(parser, state);                           //
-            next_token_keep(parser);                                         // =
-            if (token_is_type(parser, TOK_ASSIGN)) {                         //
-                token_free(&tmp);                                            //
+            if (peek_token(parser, 1)->type == TOK_ASSIGN) {                 // =
+                next_token(parser);                                          //
                 next_token(parser);                                          //
                 rule_value(parser, state);                                   // <value>
                 token_check_type(parser, TOK_SEMICOLON);                     // ;
             } else {                                                         //
                 str_clear(&parser->gen->variable);                           //
-                parser->buffer_token_valid = true;                           //
-                parser->buffer_token = parser->token;                        //
-                parser->token = tmp;                                         //
                 rule_exp(parser, state);                                     // <exp>
-                parser->buffer_token_valid = false;                          //
                 token_check_type(parser, TOK_SEMICOLON);                     // ;
             }
-            // token_free(&parser->old_token);
-
             break;
         }
         case TOK_IF:                                              // if
@@ -402,6 +429,7 @@ void rule_function(parser_t* parser, parser_state_t state) {
     next_token_check_type(parser, TOK_COLON);                         // :
     next_token_check_by_function(parser, token_is_returntype);        // type
     htab_function_add_return_type(parser->function, &parser->token);  //
+    gen_function_body(parser->gen, &parser->function->value.function);
     next_token_check_type(parser, TOK_LBRACE);                        // {
     next_token(parser);                                               //
     rule_statement(parser, state);                                    // <statement>
@@ -410,6 +438,7 @@ void rule_function(parser_t* parser, parser_state_t state) {
                      (char*)parser->function->key);                   //
     htab_function_check_params(parser->function, 0, true);            //
     htab_clear(parser->local_symtable);                               //
+    arena_reset(parser->function_arena);                              //
 }
 
 void rule_program(parser_t* parser, parser_state_t state) {
@@ -429,12 +458,12 @@ void rule_program(parser_t* parser, parser_state_t state) {
 
 void check_prolog(parser_t* parser) {
     next_token_check_type(parser, TOK_FUN_NAME);                      // declare
-    if (strcmp(parser->token.attr.val_s.val, "declare") != 0) {       //
+    if (strcmp(parser->token.attr.val_s, "declare") != 0) {           //
         error_exit(ERR_SYN);                                          //
     }                                                                 //
     next_token_check_type(parser, TOK_LPAREN);                        // (
     next_token_check_type(parser, TOK_FUN_NAME);                      // strict_types
-    if (strcmp(parser->token.attr.val_s.val, "strict_types") != 0) {  //
+    if (strcmp(parser->token.attr.val_s, "strict_types") != 0) {      //
         error_exit(ERR_SYN);                                          //
     }                                                                 //
     next_token_check_type(parser, TOK_ASSIGN);                        // =
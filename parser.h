@@ -13,23 +13,27 @@
 #define __PARSER_H__
 
 #include <stdbool.h>
+#include "arena.h"
 #include "gen.h"
 #include "scanner.h"
 #include "symtable.h"
 #include "token.h"
+#include "token_queue.h"
 
 typedef struct {
-    scanner_t* scanner;          // Scanner instance
+    token_queue_t queue;         // Tokens after the current one
+    source_t* source;            // Source of the tokens (for locations)
     gen_t* gen;                  // Generator instance
     token_t token;               // Current token
     htab_t* local_symtable;      // Local symbol table
     htab_t* global_symtable;     // Global symbol table
+    arena_t* global_arena;       // Program lifetime data (global symbol table)
+    arena_t* function_arena;     // Data of current function (local symbol table)
+    arena_t* exp_arena;          // Data of current expression (expression tree)
     htab_pair_t* function;       // Current function
     htab_pair_t* function_call;  // Current function call
     int construct_count;         // Counter of if/else/while constructs (for generator)
     int param_count;             // Counter of function call params (for checking)
-    bool buffer_token_valid;     // Is old token valid?
-    token_t buffer_token;        // Old token
     bool last_default;           // Was last case default?
 } parser_t;
 
@@ -48,6 +52,16 @@ typedef struct {
  */
 parser_t parser_new(scanner_t* scanner, gen_t* gen);
 
+/**
+ * @brief Initialize parser over already lexed tokens
+ *
+ * @param scanner Scanner which lexed the tokens
+ * @param tokens Tokens, last one has to be TOK_EOF or TOK_ERROR (parser takes ownership)
+ * @param count Number of tokens
+ * @return Initialized parser
+ */
+parser_t parser_new_from_tokens(scanner_t* scanner, token_t* tokens, size_t count, gen_t* gen);
+
 /**
  * @brief Free exising parser
  *
@@ -68,4 +82,13 @@ void parser_run(parser_t* state);
  */
 void next_token_keep(parser_t* parser);
 
+/**
+ * @brief Look at token after the current one without consuming it
+ *
+ * @param parser Instance of parser
+ * @param k Distance from the current token (1 = next token)
+ * @return Token
+ */
+token_t* peek_token(parser_t* parser, size_t k);
+
 #endif  // __PARSER_H__
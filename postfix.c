@@ -0,0 +1,83 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file postfix.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Expression in postfix notation
+ */
+
+#include "postfix.h"
+#include <string.h>
+#include "error.h"
+
+#define DEFAULT_SIZE 16
+
+postfix_t postfix_new(arena_t* arena) {
+    postfix_t postfix = {
+        .items = arena_alloc(arena, DEFAULT_SIZE * sizeof(token_t)),
+        .len = 0,
+        .size = DEFAULT_SIZE,
+        .arena = arena,
+    };
+    return postfix;
+}
+
+void postfix_add(postfix_t* postfix, token_t token) {
+    if (postfix->len == postfix->size) {
+        token_t* items = arena_alloc(postfix->arena, postfix->size * 2 * sizeof(token_t));
+        memcpy(items, postfix->items, postfix->size * sizeof(token_t));
+        postfix->items = items;
+        postfix->size *= 2;
+    }
+    postfix->items[postfix->len++] = token;
+}
+
+/**
+ * @brief Type of the result of binary operation
+ *
+ * @param type Operator
+ * @return TOK_VAR for arithmetic (int or float), TOK_BOOL_LIT or TOK_STR_LIT
+ */
+static token_type_t postfix_result(token_type_t type) {
+    switch (type) {
+        case TOK_LESS:
+        case TOK_LESS_E:
+        case TOK_GREATER:
+        case TOK_GREATER_E:
+        case TOK_EQUALS:
+        case TOK_NEQUALS:
+            return TOK_BOOL_LIT;
+        case TOK_DOT:
+            return TOK_STR_LIT;
+        default:
+            return TOK_VAR;
+    }
+}
+
+token_term_t* postfix_to_tree(postfix_t* postfix) {
+    // Operands waiting for their operator (there can't be more of them than items)
+    token_term_t** operands = arena_alloc(postfix->arena, postfix->len * sizeof(token_term_t*));
+    int count = 0;
+
+    for (int i = 0; i < postfix->len; i++) {
+        token_t* token = &postfix->items[i];
+        token_term_t* node = token_term_new(postfix->arena, *token, false);
+        if (!token_is_literal(token) && token->type != TOK_VAR) {
+            if (count < 2) {
+                error_exit(ERR_INTERNAL);
+            }
+            node->right = operands[--count];
+            node->left = operands[--count];
+            node->result = postfix_result(token->type);
+        }
+        operands[count++] = node;
+    }
+
+    if (count != 1) {
+        error_exit(ERR_INTERNAL);
+    }
+    return operands[0];
+}
@@ -0,0 +1,54 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file postfix.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Expression in postfix notation
+ *
+ * Reductions of the precedence analysis happen in post-order, so every reduced operand and
+ * operator is just appended to the buffer. Generator walks the buffer from left to right, tree is
+ * built only on request.
+ */
+
+#ifndef __POSTFIX_H__
+#define __POSTFIX_H__
+
+#include "arena.h"
+#include "token.h"
+#include "token_term.h"
+
+typedef struct {
+    token_t* items;  // Operands (literals, variables) and operators
+    int len;
+    int size;
+    arena_t* arena;  // Arena of the expression (items are allocated from it)
+} postfix_t;
+
+/**
+ * @brief Initialize empty postfix expression
+ *
+ * @param arena Arena of the expression
+ * @return New postfix_t
+ */
+postfix_t postfix_new(arena_t* arena);
+
+/**
+ * @brief Append operand or operator
+ *
+ * @param postfix Postfix expression
+ * @param token Operand or binary operator
+ */
+void postfix_add(postfix_t* postfix, token_t token);
+
+/**
+ * @brief Build expression tree (nodes are allocated from the arena of the expression)
+ *
+ * @param postfix Postfix expression (has to be valid)
+ * @return Root of the tree
+ */
+token_term_t* postfix_to_tree(postfix_t* postfix);
+
+#endif  // __POSTFIX_H__
@@ -0,0 +1,176 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file rope.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Implementation of ropes (output text stored in linked chunks)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "rope.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "error.h"
+
+// Number of chunks written by one writev call
+#define WRITE_BATCH 64
+
+rope_t rope_new() {
+    return (rope_t){.head = NULL, .tail = NULL, .len = 0};
+}
+
+void rope_free(rope_t* rope) {
+    rope_chunk_t* chunk = rope->head;
+    while (chunk != NULL) {
+        rope_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    *rope = rope_new();
+}
+
+void rope_clear(rope_t* rope) {
+    if (rope->head == NULL) {
+        return;
+    }
+    rope_chunk_t* chunk = rope->head->next;
+    while (chunk != NULL) {
+        rope_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    rope->head->next = NULL;
+    rope->head->len = 0;
+    rope->tail = rope->head;
+    rope->len = 0;
+}
+
+/**
+ * @brief Append new empty chunk (bigger ropes get bigger chunks)
+ *
+ * @param rope Rope
+ */
+static void rope_grow(rope_t* rope) {
+    size_t size = rope->len;
+    if (size < ROPE_MIN_CHUNK) {
+        size = ROPE_MIN_CHUNK;
+    } else if (size > ROPE_MAX_CHUNK) {
+        size = ROPE_MAX_CHUNK;
+    }
+    rope_chunk_t* chunk = malloc(sizeof(rope_chunk_t) + size);
+    if (chunk == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    chunk->next = NULL;
+    chunk->len = 0;
+    chunk->size = size;
+
+    if (rope->tail == NULL) {
+        rope->head = chunk;
+    } else {
+        rope->tail->next = chunk;
+    }
+    rope->tail = chunk;
+}
+
+void rope_add_cstr_n(rope_t* rope, const char* cstr, size_t n) {
+    while (n > 0) {
+        if (rope->tail == NULL || rope->tail->len == rope->tail->size) {
+            rope_grow(rope);
+        }
+        rope_chunk_t* tail = rope->tail;
+        size_t count = tail->size - tail->len;
+        if (count > n) {
+            count = n;
+        }
+        memcpy(tail->data + tail->len, cstr, count);
+        tail->len += count;
+        rope->len += count;
+        cstr += count;
+        n -= count;
+    }
+}
+
+void rope_add_char(rope_t* rope, char c) {
+    rope_add_cstr_n(rope, &c, 1);
+}
+
+void rope_add_cstr(rope_t* rope, const char* cstr) {
+    rope_add_cstr_n(rope, cstr, strlen(cstr));
+}
+
+void rope_add_str(rope_t* rope, str_t* str) {
+    rope_add_cstr_n(rope, str_val(str), str_len(str));
+}
+
+void rope_add_int(rope_t* rope, int i) {
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%d", i);
+    rope_add_cstr_n(rope, buf, len);
+}
+
+void rope_splice(rope_t* rope, rope_t* src) {
+    if (src->len == 0) {
+        return;
+    }
+    // Short text is copied, linking its partially filled chunks would waste more than copying costs
+    if (src->len < ROPE_MAX_CHUNK) {
+        for (rope_chunk_t* chunk = src->head; chunk != NULL; chunk = chunk->next) {
+            rope_add_cstr_n(rope, chunk->data, chunk->len);
+        }
+        rope_clear(src);
+        return;
+    }
+
+    if (rope->tail == NULL) {
+        rope->head = src->head;
+    } else {
+        rope->tail->next = src->head;
+    }
+    rope->tail = src->tail;
+    rope->len += src->len;
+    *src = rope_new();
+}
+
+void rope_write(rope_t* rope, FILE* file) {
+    // Anything buffered by stdio has to be written first
+    if (fflush(file) != 0) {
+        error_exit(ERR_INTERNAL);
+    }
+    const int fd = fileno(file);
+    rope_chunk_t* chunk = rope->head;
+    size_t offset = 0;  // Already written bytes of the chunk
+    while (chunk != NULL) {
+        struct iovec iov[WRITE_BATCH];
+        int count = 0;
+        for (rope_chunk_t* c = chunk; c != NULL && count < WRITE_BATCH; c = c->next) {
+            iov[count].iov_base = c->data + (c == chunk ? offset : 0);
+            iov[count].iov_len = c->len - (c == chunk ? offset : 0);
+            count++;
+        }
+
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_exit(ERR_INTERNAL);
+        }
+
+        // Skip written chunks (write can be partial)
+        size_t left = written;
+        while (chunk != NULL && left >= chunk->len - offset) {
+            left -= chunk->len - offset;
+            offset = 0;
+            chunk = chunk->next;
+        }
+        offset += left;
+    }
+}
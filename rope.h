@@ -0,0 +1,119 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file rope.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for ropes (output text stored in linked chunks)
+ *
+ * Generated code is only appended and concatenated, so it never has to be contiguous. Chunks are
+ * never reallocated and whole ropes are concatenated by linking them, nothing is copied until the
+ * final write.
+ */
+
+#ifndef __ROPE_H__
+#define __ROPE_H__
+
+#include <stddef.h>
+#include <stdio.h>
+#include "str.h"
+
+// Chunk sizes grow with the rope from the minimum to the maximum
+#define ROPE_MIN_CHUNK 256
+#define ROPE_MAX_CHUNK (1 << 16)
+
+typedef struct rope_chunk {
+    struct rope_chunk* next;  // Next chunk
+    size_t len;               // Used bytes
+    size_t size;              // Capacity
+    char data[];              // Text (not null terminated)
+} rope_chunk_t;
+
+typedef struct {
+    rope_chunk_t* head;  // First chunk (NULL if rope has no chunks)
+    rope_chunk_t* tail;  // Last chunk (text is appended here)
+    size_t len;          // Total length of text
+} rope_t;
+
+/**
+ * @brief Initialize new empty rope (nothing is allocated until first append)
+ *
+ * @return Empty rope
+ */
+rope_t rope_new();
+
+/**
+ * @brief Free all chunks of the rope
+ *
+ * @param rope Rope
+ */
+void rope_free(rope_t* rope);
+
+/**
+ * @brief Clear text of the rope (first chunk is kept for reuse)
+ *
+ * @param rope Rope
+ */
+void rope_clear(rope_t* rope);
+
+/**
+ * @brief Add first n characters of c-string to rope
+ *
+ * @param rope Destination rope
+ * @param cstr Characters (don't have to be null terminated)
+ * @param n Number of characters
+ */
+void rope_add_cstr_n(rope_t* rope, const char* cstr, size_t n);
+
+/**
+ * @brief Add character to rope
+ *
+ * @param rope Destination rope
+ * @param c Character
+ */
+void rope_add_char(rope_t* rope, char c);
+
+/**
+ * @brief Add c-string to rope
+ *
+ * @param rope Destination rope
+ * @param cstr C-String
+ */
+void rope_add_cstr(rope_t* rope, const char* cstr);
+
+/**
+ * @brief Add string to rope
+ *
+ * @param rope Destination rope
+ * @param str String (can be view)
+ */
+void rope_add_str(rope_t* rope, str_t* str);
+
+/**
+ * @brief Add int to rope
+ *
+ * @param rope Destination rope
+ * @param i Int
+ */
+void rope_add_int(rope_t* rope, int i);
+
+/**
+ * @brief Move whole text of one rope to the end of another one (chunks are linked, only text
+ * shorter than ROPE_MAX_CHUNK is copied)
+ *
+ * @param rope Destination rope
+ * @param src Source rope (empty afterwards)
+ */
+void rope_splice(rope_t* rope, rope_t* src);
+
+/**
+ * @brief Write whole rope to file (directly to its descriptor with writev, chunks are not joined)
+ *
+ * @param rope Rope
+ * @param file File (its buffer is flushed first)
+ */
+void rope_write(rope_t* rope, FILE* file);
+
+#endif  // __ROPE_H__
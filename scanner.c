@@ -11,64 +11,656 @@
 
 #include "scanner.h"
 #include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "error.h"
+#include "keywords.h"
+#include "skip.h"
 #include "str.h"
 
+int get_keyword_token_type(str_t* str) {
+    return keyword_lookup(str_val(str), str_len(str));
+}
+
 /**
- * @brief Get keyword token type
+ * @brief Skip characters using one of the fast-skip kernels
  *
- * @param str Keyword name
- * @return Keyword token type or -1 if string is not keyword
+ * @param scanner Scanner instance
+ * @param kernel Kernel returning first character that has to be handled by the state machine
  */
-int get_keyword_token_type(str_t* str) {
-    if (strcmp("else", str->val) == 0)
-        return TOK_ELSE;
-    if (strcmp("float", str->val) == 0)
-        return TOK_FLOAT;
-    if (strcmp("function", str->val) == 0)
-        return TOK_FUNCTION;
-    if (strcmp("if", str->val) == 0)
-        return TOK_IF;
-    if (strcmp("int", str->val) == 0)
-        return TOK_INT;
-    if (strcmp("null", str->val) == 0)
-        return TOK_NULL;
-    if (strcmp("return", str->val) == 0)
-        return TOK_RETURN;
-    if (strcmp("string", str->val) == 0)
-        return TOK_STRING;
-    if (strcmp("void", str->val) == 0)
-        return TOK_VOID;
-    if (strcmp("while", str->val) == 0)
-        return TOK_WHILE;
-    if (strcmp("for", str->val) == 0)
-        return TOK_FOR;
-    if (strcmp("break", str->val) == 0)
-        return TOK_BREAK;
-    if (strcmp("continue", str->val) == 0)
-        return TOK_CONTINUE;
-                
-    return -1;
+static inline void scanner_skip(scanner_t* scanner,
+                                const char* (*kernel)(const char* p, const char* end)) {
+    scanner->source.pos = kernel(scanner->source.pos, scanner->source.end);
 }
 
-token_t scanner_get_next(scanner_t* scanner) {
+/**
+ * @brief Get location of the current token (offset right after its last character)
+ *
+ * @param scanner Scanner instance
+ * @return Offset in the source
+ */
+static inline uint32_t scanner_offset(scanner_t* scanner) {
+    return scanner->source.pos - scanner->source.data;
+}
+
+/**
+ * @brief Create error token (error is reported when parser reaches the token)
+ *
+ * @param scanner Scanner instance
+ * @param code Error code
+ * @return Error token
+ */
+static inline token_t scanner_error(scanner_t* scanner, enum return_code code) {
+    return token_new_with_error(code, scanner_offset(scanner));
+}
+
+/**
+ * @brief Return last read character back to the source
+ *
+ * @param scanner Scanner instance
+ * @param c Character
+ */
+static inline void scanner_unget(scanner_t* scanner, int c) {
+    source_ungetc(&scanner->source, c);
+}
+
+/**
+ * @brief Emit token with string (interned, or kept raw if interning is turned off)
+ *
+ * @param scanner Scanner instance
+ * @param type Token type
+ * @param start Start of the string
+ * @param len Length of the string
+ * @return Token
+ */
+static inline token_t scanner_emit_string_token(scanner_t* scanner, token_type_t type,
+                                                const char* start, size_t len) {
+    if (!scanner->intern_strings) {
+        return token_new_with_raw_string(type, start - scanner->source.data, len,
+                                         scanner_offset(scanner));
+    }
+    if (type == TOK_STR_LIT) {
+        return token_new_with_string_literal(type, start, len, scanner_offset(scanner));
+    }
+    return token_new_with_string(type, start, len, scanner_offset(scanner));
+}
+
+/**
+ * @brief Emit variable or function name (interned with hash computed while scanning)
+ *
+ * @param scanner Scanner instance
+ * @param type Token type
+ * @param start Start of the name
+ * @param len Length of the name
+ * @return Token
+ */
+static inline token_t scanner_emit_name(scanner_t* scanner, token_type_t type, const char* start,
+                                        size_t len) {
+    if (!scanner->intern_strings) {
+        return scanner_emit_string_token(scanner, type, start, len);
+    }
+    return token_new_with_hashed_string(type, start, len, scanner->hash, scanner_offset(scanner));
+}
+
+/**
+ * @brief Emit variable (from start of the token to the current position, name is interned)
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static inline token_t scanner_emit_variable(scanner_t* scanner) {
+    const size_t len = scanner->source.pos - scanner->token_start;
+    return scanner_emit_name(scanner, TOK_VAR, scanner->token_start, len);
+}
+
+/**
+ * @brief Emit function name or keyword (from start of the token to the current position, function
+ * name is interned)
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static token_t scanner_emit_identifier(scanner_t* scanner) {
+    const char* start = scanner->token_start;
+    const size_t len = scanner->source.pos - start;
+    // Check if string is keyword
+    int keyword = keyword_lookup(start, len);
+    if (keyword != -1) {
+        // False means it's not optional type
+        return token_new_with_bool(keyword, false, scanner_offset(scanner));
+    } else {
+        return scanner_emit_name(scanner, TOK_FUN_NAME, start, len);
+    }
+}
+
+/**
+ * @brief Emit string literal (closing quote was just read, escape sequences are processed)
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static token_t scanner_emit_string(scanner_t* scanner) {
+    // Body between the quotes
+    const char* start = scanner->token_start + 1;
+    const size_t len = scanner->source.pos - 1 - start;
+    return scanner_emit_string_token(scanner, TOK_STR_LIT, start, len);
+}
+
+/**
+ * @brief Emit float literal (from start of the token to the current position)
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static token_t scanner_emit_float(scanner_t* scanner) {
+    const size_t len = scanner->source.pos - scanner->token_start;
+    return token_new_with_float(TOK_FLOAT_LIT,
+                                number_to_double(&scanner->number, scanner->token_start, len),
+                                scanner_offset(scanner));
+}
+
+/**
+ * @brief Emit integer literal (literal too big for int becomes float, same as in PHP)
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static token_t scanner_emit_int(scanner_t* scanner) {
+    int64_t value;
+    if (!number_to_int(&scanner->number, &value)) {
+        return scanner_emit_float(scanner);
+    }
+    return token_new_with_int(TOK_INT_LIT, value, scanner_offset(scanner));
+}
+
+/**
+ * @brief Start numeric literal
+ *
+ * @param scanner Scanner instance
+ * @param c First digit
+ */
+static inline void scanner_start_number(scanner_t* scanner, int c) {
+    scanner->token_start = scanner->source.pos - 1;
+    scanner->number = number_new();
+    number_add_digit(&scanner->number, c);
+}
+
+/**
+ * @brief Emit optional type (for example ?int) from the buffer
+ *
+ * @param scanner Scanner instance
+ * @return Token
+ */
+static token_t scanner_emit_optional_type(scanner_t* scanner) {
+    int keyword = get_keyword_token_type(&scanner->buffer);
+    if (keyword != -1 && (keyword != TOK_FLOAT || keyword != TOK_INT || keyword != TOK_STRING)) {
+        str_clear(&scanner->buffer);
+        return token_new_with_bool(keyword, true, scanner_offset(scanner));
+    } else {
+        return scanner_error(scanner, ERR_LEX);
+    }
+}
+
+#ifdef SCANNER_TABLE
+
+/**
+ * Table-driven engine: every byte is mapped to a character class and the pair
+ * (state, class) selects the next state and an action from the transition matrix.
+ */
+
+/**
+ * @brief Character classes
+ */
+enum char_class {
+    CC_OTHER,        // Anything without its own class (including bytes >= 128)
+    CC_ALPHA,        // Letters except e and E
+    CC_E,            // e and E (exponent)
+    CC_UNDERSCORE,   // _
+    CC_DIGIT,        // 0-9
+    CC_NEWLINE,      // \n
+    CC_CR,           // \r
+    CC_SPACE,        // ' '
+    CC_BLANK,        // \t, \v, \f
+    CC_CONTROL,      // Other characters < 32
+    CC_PLUS,         // +
+    CC_MINUS,        // -
+    CC_STAR,         // *
+    CC_SLASH,        // /
+    CC_DOT,          // .
+    CC_LPAREN,       // (
+    CC_RPAREN,       // )
+    CC_LBRACE,       // {
+    CC_RBRACE,       // }
+    CC_COMMA,        // ,
+    CC_SEMICOLON,    // ;
+    CC_COLON,        // :
+    CC_EQUALS,       // =
+    CC_EXCLAMATION,  // !
+    CC_LESS,         // <
+    CC_GREATER,      // >
+    CC_DOLLAR,       // $
+    CC_QUOTE,        // "
+    CC_BACKSLASH,    // \ (backslash)
+    CC_QUESTION,     // ?
+    CC_EOF,          // End of input
+    CC_COUNT,
+};
+
+/**
+ * @brief Actions executed on transition
+ */
+enum scanner_action {
+    ACT_LEX_ERROR,       // Lexical error (default for unlisted transitions)
+    ACT_SYN_ERROR,       // Syntax error (content after ?>)
+    ACT_NONE,            // Only change state
+    ACT_APPEND,          // Append character to the buffer
+    ACT_NUMBER_START,    // First digit of numeric literal
+    ACT_INT_DIGIT,       // Digit before decimal point
+    ACT_FRACTION_DIGIT,  // Digit after decimal point
+    ACT_EXPONENT_DIGIT,  // Digit of exponent
+    ACT_MARK,            // Remember start of token referencing source
+    ACT_NAME,            // Character of variable or function name (added to its hash)
+    ACT_PROLOG,          // Part of <?php
+    ACT_SKIP_BLANK,      // Skip blanks with fast-skip kernel
+    ACT_SKIP_LINE,       // Skip rest of line comment
+    ACT_SKIP_TO_STAR,    // Skip multiline comment to the next *
+    ACT_COMMENT_STAR,    // * inside of multiline comment
+    ACT_EMIT,            // Emit token without attribute
+    ACT_UNGET,           // Return character back (without token)
+    ACT_UNGET_EMIT,      // Return character back and emit token without attribute
+    ACT_UNGET_VAR,       // Return character back and emit variable
+    ACT_UNGET_IDENT,     // Return character back and emit function name or keyword
+    ACT_UNGET_INT,       // Return character back and emit integer
+    ACT_UNGET_FLOAT,     // Return character back and emit float
+    ACT_UNGET_TYPE,      // Return character back and emit optional type
+    ACT_STRING_RUN,      // Ordinary characters of string literal
+    ACT_STRING_ESCAPE,   // Escape sequence in string literal
+    ACT_STRING_END,      // Emit string literal
+    ACT_DECIMAL_POINT,   // Decimal point (has to be followed by digit)
+    ACT_EXPONENT_SIGN,   // Exponent sign (has to be followed by digit)
+    ACT_CR,              // \r after ?> (has to be followed by \n)
+};
+
+/**
+ * @brief Entry of the transition matrix
+ */
+typedef struct {
+    uint8_t next;    // Next state
+    uint8_t action;  // Action
+    uint8_t token;   // Token type for ACT_EMIT and ACT_UNGET_EMIT
+} transition_t;
+
+#define SC_COUNT (SC_TYPE_OPTIONAL + 1)
+
+// Character class of every byte, EOF (-1) is at index 0
+static uint8_t char_classes[257];
+// Transition matrix
+static transition_t transitions[SC_COUNT][CC_COUNT];
+static bool table_ready = false;
+
+/**
+ * @brief Get character class (EOF is also allowed)
+ */
+static inline int get_char_class(int c) {
+    return char_classes[c + 1];
+}
+
+/**
+ * @brief Set transition
+ */
+static void set(enum scanner_state from, int cc, enum scanner_state to, int action, int token) {
+    transitions[from][cc] = (transition_t){.next = to, .action = action, .token = token};
+}
+
+/**
+ * @brief Set transition for every character class
+ */
+static void set_all(enum scanner_state from, enum scanner_state to, int action, int token) {
+    for (int cc = 0; cc < CC_COUNT; cc++) {
+        set(from, cc, to, action, token);
+    }
+}
+
+/**
+ * @brief Set transition for identifier characters (letters, _ and optionally digits)
+ */
+static void set_ident(enum scanner_state from, bool digits, enum scanner_state to, int action) {
+    set(from, CC_ALPHA, to, action, 0);
+    set(from, CC_E, to, action, 0);
+    set(from, CC_UNDERSCORE, to, action, 0);
+    if (digits) {
+        set(from, CC_DIGIT, to, action, 0);
+    }
+}
+
+/**
+ * @brief Compute character class of byte (used only to build the table)
+ */
+static uint8_t classify(int c) {
+    if (c == 'e' || c == 'E') {
+        return CC_E;
+    } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+        return CC_ALPHA;
+    } else if (c >= '0' && c <= '9') {
+        return CC_DIGIT;
+    }
+    switch (c) {
+        case '_':
+            return CC_UNDERSCORE;
+        case '\n':
+            return CC_NEWLINE;
+        case '\r':
+            return CC_CR;
+        case ' ':
+            return CC_SPACE;
+        case '\t':
+        case '\v':
+        case '\f':
+            return CC_BLANK;
+        case '+':
+            return CC_PLUS;
+        case '-':
+            return CC_MINUS;
+        case '*':
+            return CC_STAR;
+        case '/':
+            return CC_SLASH;
+        case '.':
+            return CC_DOT;
+        case '(':
+            return CC_LPAREN;
+        case ')':
+            return CC_RPAREN;
+        case '{':
+            return CC_LBRACE;
+        case '}':
+            return CC_RBRACE;
+        case ',':
+            return CC_COMMA;
+        case ';':
+            return CC_SEMICOLON;
+        case ':':
+            return CC_COLON;
+        case '=':
+            return CC_EQUALS;
+        case '!':
+            return CC_EXCLAMATION;
+        case '<':
+            return CC_LESS;
+        case '>':
+            return CC_GREATER;
+        case '$':
+            return CC_DOLLAR;
+        case '"':
+            return CC_QUOTE;
+        case '\\':
+            return CC_BACKSLASH;
+        case '?':
+            return CC_QUESTION;
+    }
+    return c < 32 ? CC_CONTROL : CC_OTHER;
+}
+
+/**
+ * @brief Build character class table and transition matrix
+ */
+static void scanner_table_init() {
+    if (table_ready) {
+        return;
+    }
+
+    // Character classes
+    char_classes[0] = CC_EOF;
+    for (int c = 0; c < 256; c++) {
+        char_classes[c + 1] = classify(c);
+    }
+
+    // <?php
+    set_all(SC_CODE_START, SC_CODE_START, ACT_PROLOG, 0);
+    set(SC_CODE_START, CC_EOF, SC_CODE_START, ACT_LEX_ERROR, 0);
+
+    // Initial state
+    set(SC_START, CC_SPACE, SC_START, ACT_SKIP_BLANK, 0);
+    set(SC_START, CC_BLANK, SC_START, ACT_SKIP_BLANK, 0);
+    set(SC_START, CC_CR, SC_START, ACT_SKIP_BLANK, 0);
+    set(SC_START, CC_NEWLINE, SC_START, ACT_NONE, 0);
+    set(SC_START, CC_PLUS, SC_START, ACT_EMIT, TOK_PLUS);
+    set(SC_START, CC_MINUS, SC_START, ACT_EMIT, TOK_MINUS);
+    set(SC_START, CC_STAR, SC_START, ACT_EMIT, TOK_MULTIPLY);
+    set(SC_START, CC_LPAREN, SC_START, ACT_EMIT, TOK_LPAREN);
+    set(SC_START, CC_RPAREN, SC_START, ACT_EMIT, TOK_RPAREN);
+    set(SC_START, CC_LBRACE, SC_START, ACT_EMIT, TOK_LBRACE);
+    set(SC_START, CC_RBRACE, SC_START, ACT_EMIT, TOK_RBRACE);
+    set(SC_START, CC_DOT, SC_START, ACT_EMIT, TOK_DOT);
+    set(SC_START, CC_COMMA, SC_START, ACT_EMIT, TOK_COMMA);
+    set(SC_START, CC_SEMICOLON, SC_START, ACT_EMIT, TOK_SEMICOLON);
+    set(SC_START, CC_COLON, SC_START, ACT_EMIT, TOK_COLON);
+    set(SC_START, CC_EOF, SC_START, ACT_EMIT, TOK_EOF);
+    set(SC_START, CC_EQUALS, SC_ASSIGN, ACT_NONE, 0);
+    set(SC_START, CC_EXCLAMATION, SC_EXCLAMATION, ACT_NONE, 0);
+    set(SC_START, CC_LESS, SC_LESS, ACT_NONE, 0);
+    set(SC_START, CC_GREATER, SC_GREATER, ACT_NONE, 0);
+    set(SC_START, CC_DOLLAR, SC_VARIABLE_START, ACT_MARK, 0);
+    set(SC_START, CC_QUOTE, SC_STRING_LIT, ACT_MARK, 0);
+    set(SC_START, CC_SLASH, SC_DIVIDE, ACT_NONE, 0);
+    set(SC_START, CC_QUESTION, SC_QUESTION_MARK, ACT_NONE, 0);
+    set_ident(SC_START, false, SC_FUNCTION, ACT_MARK);
+    set(SC_START, CC_DIGIT, SC_NUMBER, ACT_NUMBER_START, 0);
+
+    // Operators
+    set_all(SC_ASSIGN, SC_START, ACT_UNGET_EMIT, TOK_ASSIGN);
+    set(SC_ASSIGN, CC_EQUALS, SC_EQUALS, ACT_NONE, 0);
+    set(SC_EQUALS, CC_EQUALS, SC_START, ACT_EMIT, TOK_EQUALS);
+    set(SC_EXCLAMATION, CC_EQUALS, SC_NEQUALS, ACT_NONE, 0);
+    set(SC_NEQUALS, CC_EQUALS, SC_START, ACT_EMIT, TOK_NEQUALS);
+    set_all(SC_LESS, SC_START, ACT_UNGET_EMIT, TOK_LESS);
+    set(SC_LESS, CC_EQUALS, SC_START, ACT_EMIT, TOK_LESS_E);
+    set_all(SC_GREATER, SC_START, ACT_UNGET_EMIT, TOK_GREATER);
+    set(SC_GREATER, CC_EQUALS, SC_START, ACT_EMIT, TOK_GREATER_E);
+
+    // Variables, function names and keywords (characters stay in the source)
+    set_ident(SC_VARIABLE_START, false, SC_VARIABLE, ACT_NAME);
+    set_all(SC_VARIABLE, SC_START, ACT_UNGET_VAR, 0);
+    set_ident(SC_VARIABLE, true, SC_VARIABLE, ACT_NAME);
+    set_all(SC_FUNCTION, SC_START, ACT_UNGET_IDENT, 0);
+    set_ident(SC_FUNCTION, true, SC_FUNCTION, ACT_NAME);
+
+    // String literals (everything >= 32 is ordinary character, characters stay in the source)
+    set_all(SC_STRING_LIT, SC_STRING_LIT, ACT_STRING_RUN, 0);
+    set(SC_STRING_LIT, CC_NEWLINE, SC_STRING_LIT, ACT_LEX_ERROR, 0);
+    set(SC_STRING_LIT, CC_CR, SC_STRING_LIT, ACT_LEX_ERROR, 0);
+    set(SC_STRING_LIT, CC_BLANK, SC_STRING_LIT, ACT_LEX_ERROR, 0);
+    set(SC_STRING_LIT, CC_CONTROL, SC_STRING_LIT, ACT_LEX_ERROR, 0);
+    set(SC_STRING_LIT, CC_EOF, SC_STRING_LIT, ACT_LEX_ERROR, 0);
+    set(SC_STRING_LIT, CC_BACKSLASH, SC_STRING_LIT, ACT_STRING_ESCAPE, 0);
+    set(SC_STRING_LIT, CC_QUOTE, SC_START, ACT_STRING_END, 0);
+
+    // Division and comments
+    set_all(SC_DIVIDE, SC_START, ACT_UNGET_EMIT, TOK_DIVIDE);
+    set(SC_DIVIDE, CC_STAR, SC_MCOMMENT, ACT_NONE, 0);
+    set(SC_DIVIDE, CC_SLASH, SC_LCOMMENT, ACT_NONE, 0);
+    set_all(SC_LCOMMENT, SC_LCOMMENT, ACT_SKIP_LINE, 0);
+    set(SC_LCOMMENT, CC_NEWLINE, SC_START, ACT_NONE, 0);
+    set(SC_LCOMMENT, CC_EOF, SC_START, ACT_NONE, 0);
+    set_all(SC_MCOMMENT, SC_MCOMMENT, ACT_SKIP_TO_STAR, 0);
+    set(SC_MCOMMENT, CC_STAR, SC_MCOMMENT, ACT_COMMENT_STAR, 0);
+    set(SC_MCOMMENT, CC_EOF, SC_MCOMMENT, ACT_LEX_ERROR, 0);
+
+    // ?> and optional types
+    set(SC_QUESTION_MARK, CC_GREATER, SC_END, ACT_NONE, 0);
+    set(SC_QUESTION_MARK, CC_ALPHA, SC_TYPE_OPTIONAL, ACT_UNGET, 0);
+    set(SC_QUESTION_MARK, CC_E, SC_TYPE_OPTIONAL, ACT_UNGET, 0);
+    set_all(SC_TYPE_OPTIONAL, SC_START, ACT_UNGET_TYPE, 0);
+    set(SC_TYPE_OPTIONAL, CC_ALPHA, SC_TYPE_OPTIONAL, ACT_APPEND, 0);
+    set(SC_TYPE_OPTIONAL, CC_E, SC_TYPE_OPTIONAL, ACT_APPEND, 0);
+
+    // There can't be anything after ?> except \n and \r\n
+    set_all(SC_END, SC_END, ACT_SYN_ERROR, 0);
+    set(SC_END, CC_EOF, SC_END, ACT_EMIT, TOK_EOF);
+    set(SC_END, CC_NEWLINE, SC_HARDEND, ACT_NONE, 0);
+    set(SC_END, CC_CR, SC_HARDEND, ACT_CR, 0);
+    set_all(SC_HARDEND, SC_HARDEND, ACT_SYN_ERROR, 0);
+    set(SC_HARDEND, CC_EOF, SC_HARDEND, ACT_EMIT, TOK_EOF);
+
+    // Numbers (letter right after number is an error)
+    set_all(SC_NUMBER, SC_START, ACT_UNGET_INT, 0);
+    set(SC_NUMBER, CC_DIGIT, SC_NUMBER, ACT_INT_DIGIT, 0);
+    set(SC_NUMBER, CC_DOT, SC_FLOAT, ACT_DECIMAL_POINT, 0);
+    set(SC_NUMBER, CC_E, SC_EXPONENT_SIGN, ACT_NONE, 0);
+    set(SC_NUMBER, CC_ALPHA, SC_NUMBER, ACT_LEX_ERROR, 0);
+    set_all(SC_FLOAT, SC_START, ACT_UNGET_FLOAT, 0);
+    set(SC_FLOAT, CC_DIGIT, SC_FLOAT, ACT_FRACTION_DIGIT, 0);
+    set(SC_FLOAT, CC_E, SC_EXPONENT_SIGN, ACT_NONE, 0);
+    set(SC_FLOAT, CC_ALPHA, SC_FLOAT, ACT_LEX_ERROR, 0);
+    set(SC_EXPONENT_SIGN, CC_PLUS, SC_EXPONENT, ACT_EXPONENT_SIGN, 0);
+    set(SC_EXPONENT_SIGN, CC_MINUS, SC_EXPONENT, ACT_EXPONENT_SIGN, 0);
+    set(SC_EXPONENT_SIGN, CC_DIGIT, SC_EXPONENT, ACT_UNGET, 0);
+    set_all(SC_EXPONENT, SC_START, ACT_UNGET_FLOAT, 0);
+    set(SC_EXPONENT, CC_DIGIT, SC_EXPONENT, ACT_EXPONENT_DIGIT, 0);
+    set(SC_EXPONENT, CC_ALPHA, SC_EXPONENT, ACT_LEX_ERROR, 0);
+    set(SC_EXPONENT, CC_E, SC_EXPONENT, ACT_LEX_ERROR, 0);
+
+    table_ready = true;
+}
+
+static token_t scanner_scan(scanner_t* scanner) {
+    while (true) {
+        const int c = source_getc(&scanner->source);
+        const transition_t t = transitions[scanner->state][get_char_class(c)];
+        scanner->state = t.next;
+
+        switch (t.action) {
+            case ACT_LEX_ERROR:
+                return scanner_error(scanner, ERR_LEX);
+            case ACT_SYN_ERROR:
+                return scanner_error(scanner, ERR_SYN);
+            case ACT_NONE:
+                break;
+            case ACT_APPEND:
+                str_add_char(&scanner->buffer, c);
+                break;
+            case ACT_NUMBER_START:
+                scanner_start_number(scanner, c);
+                break;
+            case ACT_INT_DIGIT:
+                number_add_digit(&scanner->number, c);
+                break;
+            case ACT_FRACTION_DIGIT:
+                number_add_fraction_digit(&scanner->number, c);
+                break;
+            case ACT_EXPONENT_DIGIT:
+                number_add_exponent_digit(&scanner->number, c);
+                break;
+            case ACT_MARK:
+                scanner->token_start = scanner->source.pos - 1;
+                scanner->hash = intern_hash_step(0, c);
+                break;
+            case ACT_NAME:
+                scanner->hash = intern_hash_step(scanner->hash, c);
+                break;
+            case ACT_PROLOG:
+                str_add_char(&scanner->buffer, c);
+                if (str_len(&scanner->buffer) == 5) {  // <?php
+                    if (strcmp(str_val(&scanner->buffer), "<?php") != 0) {
+                        return scanner_error(scanner, ERR_LEX);
+                    }
+                    str_clear(&scanner->buffer);
+                    scanner->state = SC_START;
+                }
+                break;
+            case ACT_SKIP_BLANK:
+                scanner_skip(scanner, skip_blank);
+                break;
+            case ACT_SKIP_LINE:
+                scanner_skip(scanner, skip_to_newline);
+                break;
+            case ACT_SKIP_TO_STAR:
+                scanner_skip(scanner, skip_to_star);
+                break;
+            case ACT_COMMENT_STAR: {
+                const int c2 = source_getc(&scanner->source);
+                if (c2 == '/') {
+                    scanner->state = SC_START;
+                } else {
+                    source_ungetc(&scanner->source, c2);
+                }
+                break;
+            }
+            case ACT_EMIT:
+                // End of file is located after the last character
+                return token_new(t.token, scanner_offset(scanner) + (c == EOF));
+            case ACT_UNGET:
+                scanner_unget(scanner, c);
+                break;
+            case ACT_UNGET_EMIT:
+                scanner_unget(scanner, c);
+                return token_new(t.token, scanner_offset(scanner));
+            case ACT_UNGET_VAR:
+                scanner_unget(scanner, c);
+                return scanner_emit_variable(scanner);
+            case ACT_UNGET_IDENT:
+                scanner_unget(scanner, c);
+                return scanner_emit_identifier(scanner);
+            case ACT_UNGET_INT:
+                scanner_unget(scanner, c);
+                return scanner_emit_int(scanner);
+            case ACT_UNGET_FLOAT:
+                scanner_unget(scanner, c);
+                return scanner_emit_float(scanner);
+            case ACT_UNGET_TYPE:
+                scanner_unget(scanner, c);
+                return scanner_emit_optional_type(scanner);
+            case ACT_STRING_ESCAPE: {
+                // Escaped quote and backslash are skipped together with the backslash
+                const int c2 = source_getc(&scanner->source);
+                if (c2 == '"') {
+                    break;
+                } else if (c2 != '\\') {
+                    source_ungetc(&scanner->source, c2);
+                }
+            }
+            // fall through
+            case ACT_STRING_RUN:
+                // Skip ordinary characters up to the next quote, escape or control character
+                scanner_skip(scanner, skip_string_body);
+                break;
+            case ACT_STRING_END:
+                return scanner_emit_string(scanner);
+            case ACT_DECIMAL_POINT:
+            case ACT_EXPONENT_SIGN:
+                // There has to be a digit after the decimal point or exponent sign
+                if (get_char_class(source_peek(&scanner->source, 0)) != CC_DIGIT) {
+                    return scanner_error(scanner, ERR_LEX);
+                }
+                scanner->number.exp_negative = c == '-';
+                break;
+            case ACT_CR:
+                if (source_getc(&scanner->source) != '\n') {
+                    return scanner_error(scanner, ERR_SYN);
+                }
+                break;
+        }
+    }
+}
+
+#else  // SCANNER_TABLE
+
+static token_t scanner_scan(scanner_t* scanner) {
     while (true) {
-        scanner->col_nr++;
-        const int c = fgetc(scanner->input);
+        const int c = source_getc(&scanner->source);
 
         switch (scanner->state) {
             case SC_CODE_START: {
                 // If we encounter EOF in this state it's an error
                 if (c == EOF) {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
 
                 str_add_char(&scanner->buffer, c);
-                if (scanner->buffer.len == 5) {  // <?php
-                    if (strcmp(scanner->buffer.val, "<?php") != 0) {
-                        error_exit(ERR_LEX);
+                if (str_len(&scanner->buffer) == 5) {  // <?php
+                    if (strcmp(str_val(&scanner->buffer), "<?php") != 0) {
+                        return scanner_error(scanner, ERR_LEX);
                     } else {
                         str_clear(&scanner->buffer);
                         scanner->state = SC_START;
@@ -80,10 +672,9 @@ token_t scanner_get_next(scanner_t* scanner) {
             case SC_START: {
                 // Skip whitespaces
                 if (isspace(c)) {
-                    if (c == '\n') {
-                        scanner->col_nr = 0;
-                        scanner->line_nr++;
-                    } else {
+                    if (c != '\n') {
+                        // Jump over the rest of the blanks at once
+                        scanner_skip(scanner, skip_blank);
                     }
                     break;
                 }
@@ -91,29 +682,29 @@ token_t scanner_get_next(scanner_t* scanner) {
                 // Single char tokens (that are for sure end states)
                 switch (c) {
                     case '+':
-                        return token_new(TOK_PLUS, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_PLUS, scanner_offset(scanner));
                     case '-':
-                        return token_new(TOK_MINUS, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_MINUS, scanner_offset(scanner));
                     case '*':
-                        return token_new(TOK_MULTIPLY, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_MULTIPLY, scanner_offset(scanner));
                     case '(':
-                        return token_new(TOK_LPAREN, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_LPAREN, scanner_offset(scanner));
                     case ')':
-                        return token_new(TOK_RPAREN, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_RPAREN, scanner_offset(scanner));
                     case '{':
-                        return token_new(TOK_LBRACE, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_LBRACE, scanner_offset(scanner));
                     case '}':
-                        return token_new(TOK_RBRACE, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_RBRACE, scanner_offset(scanner));
                     case '.':
-                        return token_new(TOK_DOT, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_DOT, scanner_offset(scanner));
                     case ',':
-                        return token_new(TOK_COMMA, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_COMMA, scanner_offset(scanner));
                     case ';':
-                        return token_new(TOK_SEMICOLON, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_SEMICOLON, scanner_offset(scanner));
                     case ':':
-                        return token_new(TOK_COLON, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_COLON, scanner_offset(scanner));
                     case EOF:
-                        return token_new(TOK_EOF, scanner->line_nr, scanner->col_nr);
+                        return token_new(TOK_EOF, scanner_offset(scanner) + 1);
                 }
 
                 // Multi char tokens
@@ -132,10 +723,12 @@ token_t scanner_get_next(scanner_t* scanner) {
                         continue;
                     case '$':
                         scanner->state = SC_VARIABLE_START;
-                        str_add_char(&scanner->buffer, c);
+                        scanner->token_start = scanner->source.pos - 1;
+                        scanner->hash = intern_hash_step(0, c);
                         continue;
                     case '"':
                         scanner->state = SC_STRING_LIT;
+                        scanner->token_start = scanner->source.pos - 1;
                         continue;
                     case '/':
                         scanner->state = SC_DIVIDE;
@@ -148,40 +741,38 @@ token_t scanner_get_next(scanner_t* scanner) {
                 // Function names and keywords
                 if (isalpha(c) || c == '_') {
                     scanner->state = SC_FUNCTION;
-
-                    str_add_char(&scanner->buffer, c);
+                    scanner->token_start = scanner->source.pos - 1;
+                    scanner->hash = intern_hash_step(0, c);
                     break;
                 }
 
                 // Numbers
                 if (isdigit(c)) {
                     scanner->state = SC_NUMBER;
-
-                    str_add_char(&scanner->buffer, c);
+                    scanner_start_number(scanner, c);
                     break;
                 }
 
-                error_exit(ERR_LEX);
+                return scanner_error(scanner, ERR_LEX);
                 break;
             }
             case SC_ASSIGN: {
                 if (c == '=') {
                     scanner->state = SC_EQUALS;
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new(TOK_ASSIGN, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_ASSIGN, scanner_offset(scanner));
                 }
                 break;
             }
             case SC_EQUALS: {
                 if (c == '=') {
                     scanner->state = SC_START;
-                    return token_new(TOK_EQUALS, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_EQUALS, scanner_offset(scanner));
                 } else {
                     // We don't have == token
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
@@ -190,153 +781,129 @@ token_t scanner_get_next(scanner_t* scanner) {
                     scanner->state = SC_NEQUALS;
                 } else {
                     // We don't have ! token
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_NEQUALS: {
                 if (c == '=') {
                     scanner->state = SC_START;
-                    return token_new(TOK_NEQUALS, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_NEQUALS, scanner_offset(scanner));
                 } else {
                     // We don't have != token
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_LESS: {
                 scanner->state = SC_START;
                 if (c == '=') {
-                    return token_new(TOK_LESS_E, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_LESS_E, scanner_offset(scanner));
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
-                    return token_new(TOK_LESS, scanner->line_nr, scanner->col_nr);
+                    scanner_unget(scanner, c);
+                    return token_new(TOK_LESS, scanner_offset(scanner));
                 }
                 break;
             }
             case SC_GREATER: {
                 scanner->state = SC_START;
                 if (c == '=') {
-                    return token_new(TOK_GREATER_E, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_GREATER_E, scanner_offset(scanner));
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
-                    return token_new(TOK_GREATER, scanner->line_nr, scanner->col_nr);
+                    scanner_unget(scanner, c);
+                    return token_new(TOK_GREATER, scanner_offset(scanner));
                 }
                 break;
             }
             case SC_VARIABLE_START: {
                 if (isalpha(c) || c == '_') {
-                    str_add_char(&scanner->buffer, c);
                     scanner->state = SC_VARIABLE;
+                    scanner->hash = intern_hash_step(scanner->hash, c);
                 } else {
                     // There has to be valid character after $
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_VARIABLE: {
-                if (isalnum(c) || c == '_') {
-                    str_add_char(&scanner->buffer, c);
-                } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                if (!(isalnum(c) || c == '_')) {
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new_with_string(TOK_VAR, &scanner->buffer, scanner->line_nr,
-                                                 scanner->col_nr);
+                    return scanner_emit_variable(scanner);
                 }
+                scanner->hash = intern_hash_step(scanner->hash, c);
                 break;
             }
             case SC_FUNCTION: {
-                if (isalnum(c) || c == '_') {
-                    str_add_char(&scanner->buffer, c);
-                } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                if (!(isalnum(c) || c == '_')) {
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    // Check if string is keyword
-                    int keyword = get_keyword_token_type(&scanner->buffer);
-                    if (keyword != -1) {
-                        str_clear(&scanner->buffer);
-                        // False means it's not optional type
-                        return token_new_with_bool(keyword, false, scanner->line_nr,
-                                                   scanner->col_nr);
-                    } else {
-                        return token_new_with_string(TOK_FUN_NAME, &scanner->buffer,
-                                                     scanner->line_nr, scanner->col_nr);
-                    }
+                    return scanner_emit_identifier(scanner);
                 }
+                scanner->hash = intern_hash_step(scanner->hash, c);
                 break;
             }
             case SC_STRING_LIT: {
                 if (c == EOF) {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
 
-                // Handle escape sequence
+                // Handle escape sequence (escaped quote and backslash are skipped together with
+                // the backslash, literal is processed later by token_new_with_string_literal)
                 if (c == '\\') {
-                    const int c2 = getc(scanner->input);
+                    const int c2 = source_getc(&scanner->source);
                     if (c2 == '"') {
-                        str_add_char(&scanner->buffer, '"');
                         break;
-                    } else if (c2 == '\\') {
-                        str_add_char(&scanner->buffer, '\\');
-                    } else {
-                        ungetc(c2, scanner->input);
+                    } else if (c2 != '\\') {
+                        source_ungetc(&scanner->source, c2);
                     }
                 }
 
                 if (c == '"') {
                     scanner->state = SC_START;
-                    return token_new_with_string_literal(TOK_STR_LIT, &scanner->buffer,
-                                                         scanner->line_nr, scanner->col_nr);
+                    return scanner_emit_string(scanner);
                 } else if (c >= 32) {
-                    str_add_char(&scanner->buffer, c);
+                    // Skip ordinary characters up to the next quote, escape or control character
+                    scanner_skip(scanner, skip_string_body);
                 } else {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_DIVIDE: {
                 if (c == '*') {
-                    scanner->col_nr = 0;
-                    scanner->line_nr++;
                     scanner->state = SC_MCOMMENT;
                 } else if (c == '/') {
                     scanner->state = SC_LCOMMENT;
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new(TOK_DIVIDE, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_DIVIDE, scanner_offset(scanner));
                 }
                 break;
             }
             case SC_LCOMMENT: {
                 if (c == '\n' || c == EOF) {
-                    if (c == '\n') {
-                        scanner->col_nr = 0;
-                        scanner->line_nr++;
-                    }
                     scanner->state = SC_START;
+                } else {
+                    scanner_skip(scanner, skip_to_newline);
                 }
                 break;
             }
             case SC_MCOMMENT: {
                 if (c == EOF) {
-                    error_exit(ERR_LEX);  // Unterminated comment
+                    return scanner_error(scanner, ERR_LEX);  // Unterminated comment
                 } else if (c == '*') {
-                    scanner->col_nr = 0;
-                    scanner->line_nr++;
-                    const int c2 = fgetc(scanner->input);
+                    const int c2 = source_getc(&scanner->source);
                     if (c2 == '/') {
                         scanner->state = SC_START;
                     } else if (c == EOF) {
-                        error_exit(ERR_LEX);
+                        return scanner_error(scanner, ERR_LEX);
                     } else {
-                        ungetc(c2, scanner->input);
+                        source_ungetc(&scanner->source, c2);
                     }
+                } else {
+                    scanner_skip(scanner, skip_to_star);
                 }
                 break;
             }
@@ -344,111 +911,97 @@ token_t scanner_get_next(scanner_t* scanner) {
                 if (c == '>') {
                     scanner->state = SC_END;
                 } else if (isalpha(c)) {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_TYPE_OPTIONAL;
                 } else {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_END: {
                 if (c == EOF) {
-                    return token_new(TOK_EOF, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_EOF, scanner_offset(scanner) + 1);
                 }
 
-                if (c == '\n' || (c == '\r' && getc(scanner->input) == '\n')) {
+                if (c == '\n' || (c == '\r' && source_getc(&scanner->source) == '\n')) {
                     scanner->state = SC_HARDEND;
                     break;
                 } else {
                     // There can't be anything after ?> except \n and \r\n
-                    error_exit(ERR_SYN);
+                    return scanner_error(scanner, ERR_SYN);
                 }
                 break;
             }
             case SC_HARDEND: {
                 // Only EOF is allowed after hard end
                 if (c == EOF) {
-                    return token_new(TOK_EOF, scanner->line_nr, scanner->col_nr);
+                    return token_new(TOK_EOF, scanner_offset(scanner) + 1);
                 }
-                error_exit(ERR_SYN);
+                return scanner_error(scanner, ERR_SYN);
                 break;
             }
             case SC_NUMBER: {
                 if (isdigit(c)) {
-                    str_add_char(&scanner->buffer, c);
+                    number_add_digit(&scanner->number, c);
                 } else if (c == '.') {
-                    str_add_char(&scanner->buffer, c);
-                    const int c2 = fgetc(scanner->input);
-                    if (isdigit(c2)) {
-                        ungetc(c2, scanner->input);
+                    // There has to be a digit after the decimal point
+                    if (isdigit(source_peek(&scanner->source, 0))) {
                         scanner->state = SC_FLOAT;
                     } else {
-                        error_exit(ERR_LEX);
+                        return scanner_error(scanner, ERR_LEX);
                     }
                 } else if (c == 'e' || c == 'E') {
-                    str_add_char(&scanner->buffer, c);
                     scanner->state = SC_EXPONENT_SIGN;
                 } else if (isalpha(c)) {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new_with_int(TOK_INT_LIT, &scanner->buffer, scanner->line_nr,
-                                              scanner->col_nr);
+                    return scanner_emit_int(scanner);
                 }
                 break;
             }
             case SC_FLOAT: {
                 if (isdigit(c)) {
-                    str_add_char(&scanner->buffer, c);
+                    number_add_fraction_digit(&scanner->number, c);
                 } else if (c == 'e' || c == 'E') {
-                    str_add_char(&scanner->buffer, 'e');
                     scanner->state = SC_EXPONENT_SIGN;
                 } else if (isalpha(c)) {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new_with_float(TOK_FLOAT_LIT, &scanner->buffer, scanner->line_nr,
-                                                scanner->col_nr);
+                    return scanner_emit_float(scanner);
                 }
                 break;
             }
 
             case SC_EXPONENT_SIGN: {
                 if (c == '+' || c == '-') {
-                    const int c2 = getc(scanner->input);
-                    if (isdigit(c2)) {
-                        ungetc(c2, scanner->input);
-
-                        str_add_char(&scanner->buffer, c);
+                    // There has to be a digit after the exponent sign
+                    if (isdigit(source_peek(&scanner->source, 0))) {
+                        scanner->number.exp_negative = c == '-';
                         scanner->state = SC_EXPONENT;
                     } else {
-                        error_exit(ERR_LEX);
+                        return scanner_error(scanner, ERR_LEX);
                     }
                 } else if (isdigit(c)) {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_EXPONENT;
                 } else {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 }
                 break;
             }
             case SC_EXPONENT: {
                 if (isdigit(c)) {
-                    str_add_char(&scanner->buffer, c);
+                    number_add_exponent_digit(&scanner->number, c);
                 } else if (isalpha(c)) {
-                    error_exit(ERR_LEX);
+                    return scanner_error(scanner, ERR_LEX);
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
+                    scanner_unget(scanner, c);
                     scanner->state = SC_START;
-                    return token_new_with_float(TOK_FLOAT_LIT, &scanner->buffer, scanner->line_nr,
-                                                scanner->col_nr);
+                    return scanner_emit_float(scanner);
                 }
                 break;
             }
@@ -456,18 +1009,9 @@ token_t scanner_get_next(scanner_t* scanner) {
                 if (isalpha(c)) {
                     str_add_char(&scanner->buffer, c);
                 } else {
-                    scanner->col_nr--;
-                    ungetc(c, scanner->input);
-                    int keyword = get_keyword_token_type(&scanner->buffer);
-                    if (keyword != -1 &&
-                        (keyword != TOK_FLOAT || keyword != TOK_INT || keyword != TOK_STRING)) {
-                        scanner->state = SC_START;
-                        str_clear(&scanner->buffer);
-                        return token_new_with_bool(keyword, true, scanner->line_nr,
-                                                   scanner->col_nr);
-                    } else {
-                        error_exit(ERR_LEX);
-                    }
+                    scanner_unget(scanner, c);
+                    scanner->state = SC_START;
+                    return scanner_emit_optional_type(scanner);
                 }
                 break;
             }
@@ -475,11 +1019,60 @@ token_t scanner_get_next(scanner_t* scanner) {
     }
 }
 
+#endif  // SCANNER_TABLE
+
+token_t scanner_get_next(scanner_t* scanner) {
+    token_t token = scanner_scan(scanner);
+    if (token.type == TOK_ERROR) {
+        error_exit(token.attr.val_i);
+    }
+    return token;
+}
+
+size_t scanner_fill(scanner_t* scanner, token_t* tokens, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        tokens[i] = scanner_scan(scanner);
+        // Nothing can follow end of file or error
+        if (tokens[i].type == TOK_EOF || tokens[i].type == TOK_ERROR) {
+            return i + 1;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Initialize scanner over existing source
+ *
+ * @param source Source
+ * @return Initialized scanner
+ */
+scanner_t scanner_new_from_source(source_t source) {
+    // Token locations are 32-bit offsets
+    if ((size_t)(source.end - source.data) >= UINT32_MAX) {
+        error_exit(ERR_INTERNAL);
+    }
+#ifdef SCANNER_TABLE
+    scanner_table_init();
+#endif
+    return (scanner_t){.buffer = str_new(),
+                       .state = SC_CODE_START,
+                       .source = source,
+                       .intern_strings = true};
+}
+
 scanner_t scanner_new(FILE* input) {
-    return (scanner_t){
-        .buffer = str_new(), .state = SC_CODE_START, .input = input, .line_nr = 1, .col_nr = 0};
+    return scanner_new_from_source(source_new_from_file(input));
+}
+
+scanner_t scanner_new_from_fd(int fd) {
+    return scanner_new_from_source(source_new_from_fd(fd));
+}
+
+scanner_t scanner_new_from_buffer(const char* buf, size_t len) {
+    return scanner_new_from_source(source_new_from_buffer(buf, len));
 }
 
 void scanner_free(scanner_t* scanner) {
     str_free(&scanner->buffer);
+    source_free(&scanner->source);
 }
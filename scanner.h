@@ -12,7 +12,11 @@
 #ifndef __SCANNER_H__
 #define __SCANNER_H__
 
+#include <stdbool.h>
 #include <stdio.h>
+#include "number.h"
+#include "source.h"
+#include "str.h"
 #include "token.h"
 
 enum scanner_state {
@@ -44,26 +48,65 @@ enum scanner_state {
 typedef struct {
     enum scanner_state state;  // Current state
     str_t buffer;              // Buffer for previous characters
-    FILE* input;               // Input stream
-    size_t line_nr;
-    size_t col_nr;
+    source_t source;           // Input (whole source in memory)
+    const char* token_start;   // Start of current variable, function name or string literal
+    uint32_t hash;             // Hash of current variable or function name (see intern_hash_step)
+    bool intern_strings;       // Intern names and string literals (off in parallel workers)
+    number_t number;           // Value of numeric literal being scanned
 } scanner_t;
 
 /**
- * @brief Get next token from input stream
+ * @brief Get keyword token type (uses perfect hash generated from token.h)
+ *
+ * @param str Keyword name
+ * @return Keyword token type or -1 if string is not keyword
+ */
+int get_keyword_token_type(str_t* str);
+
+/**
+ * @brief Get next token from input stream (exits on lexical error)
  *
  * @param state Current state of the scanner
  * @return Next token
  */
 token_t scanner_get_next(scanner_t* state);
 
+/**
+ * @brief Scan up to n tokens at once, lexical errors are not reported but returned as TOK_ERROR
+ * (scanner can't be used after TOK_ERROR)
+ *
+ * @param scanner Scanner instance
+ * @param tokens Output array
+ * @param n Maximum number of tokens
+ * @return Number of scanned tokens (less than n only if the last one is TOK_EOF or TOK_ERROR)
+ */
+size_t scanner_fill(scanner_t* scanner, token_t* tokens, size_t n);
+
 /**
  * @brief Initialize scanner
  *
+ * @param input Input stream
  * @return Initialized scanner
  */
 scanner_t scanner_new(FILE* input);
 
+/**
+ * @brief Initialize scanner reading from file descriptor
+ *
+ * @param fd File descriptor
+ * @return Initialized scanner
+ */
+scanner_t scanner_new_from_fd(int fd);
+
+/**
+ * @brief Initialize scanner over in-memory buffer (buffer has to outlive the scanner)
+ *
+ * @param buf Buffer with source code
+ * @param len Length of the buffer
+ * @return Initialized scanner
+ */
+scanner_t scanner_new_from_buffer(const char* buf, size_t len);
+
 /**
  * @brief Free existing scanner
  *
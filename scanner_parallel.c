@@ -0,0 +1,244 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file scanner_parallel.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Parallel speculative lexing of large sources
+ */
+
+#include "scanner_parallel.h"
+#include <pthread.h>
+#include <string.h>
+#include "error.h"
+#include "skip.h"
+
+/**
+ * @brief Growing array of tokens together with input position right after every token
+ */
+typedef struct {
+    token_t* tokens;     // Tokens
+    const char** ends;   // Position after every token
+    size_t count;        // Number of tokens
+    size_t size;         // Allocated number of tokens
+} token_run_t;
+
+/**
+ * @brief Chunk of input lexed speculatively by one worker
+ */
+typedef struct {
+    const char* start;      // First character of the chunk (always start of a line)
+    const char* end;        // First character of the next chunk
+    const char* input_end;  // End of the whole input
+    token_run_t run;        // Speculative tokens (offsets are relative to the chunk start)
+    size_t checked;         // Tokens before this index end before current position of stitching
+    pthread_t thread;       // Worker
+    bool joined;            // Has the worker already finished?
+} chunk_t;
+
+/**
+ * @brief Append token to the run
+ *
+ * @param run Token run
+ * @param token Token
+ * @param end Input position after the token
+ */
+static void token_run_push(token_run_t* run, token_t token, const char* end) {
+    if (run->count == run->size) {
+        size_t size = run->size == 0 ? 1024 : run->size * 2;
+        token_t* tokens = realloc(run->tokens, size * sizeof(token_t));
+        if (tokens == NULL) {
+            error_exit(ERR_INTERNAL);
+        }
+        run->tokens = tokens;
+        const char** ends = realloc(run->ends, size * sizeof(const char*));
+        if (ends == NULL) {
+            error_exit(ERR_INTERNAL);
+        }
+        run->ends = ends;
+        run->size = size;
+    }
+    run->tokens[run->count] = token;
+    run->ends[run->count] = end;
+    run->count++;
+}
+
+/**
+ * @brief Check if scanning has to stop after token
+ */
+static inline bool is_last_token(token_t* token) {
+    return token->type == TOK_EOF || token->type == TOK_ERROR;
+}
+
+/**
+ * @brief Worker lexing one chunk as if it started in SC_START (stops after the first token
+ * reaching the next chunk)
+ *
+ * @param arg Chunk
+ * @return NULL
+ */
+static void* chunk_lex(void* arg) {
+    chunk_t* chunk = arg;
+    scanner_t scanner = scanner_new_from_buffer(chunk->start, chunk->input_end - chunk->start);
+    scanner.state = SC_START;
+    // Intern pool is not thread safe, strings are interned when the tokens are stitched
+    scanner.intern_strings = false;
+
+    token_t token;
+    do {
+        scanner_fill(&scanner, &token, 1);
+        token_run_push(&chunk->run, token, scanner.source.pos);
+    } while (!is_last_token(&token) && scanner.source.pos < chunk->end);
+
+    scanner_free(&scanner);
+    return NULL;
+}
+
+/**
+ * @brief Wait for worker of the chunk
+ *
+ * @param chunk Chunk
+ */
+static void chunk_join(chunk_t* chunk) {
+    if (!chunk->joined) {
+        if (pthread_join(chunk->thread, NULL) != 0) {
+            error_exit(ERR_INTERNAL);
+        }
+        chunk->joined = true;
+    }
+}
+
+/**
+ * @brief Try to continue with speculative tokens of the chunk from the current scanner position
+ *
+ * Speculative tokens can be used if the scanner is in SC_START exactly at the start of the chunk
+ * or right after one of the speculative tokens, because the speculative scanner was in the same
+ * state there. Offsets are relative to the chunk start and only have to be shifted.
+ *
+ * @param scanner Real scanner (moved after the last used token)
+ * @param chunk Chunk
+ * @param out Result
+ * @return true if tokens were used
+ */
+static bool chunk_stitch(scanner_t* scanner, chunk_t* chunk, token_run_t* out) {
+    if (scanner->state != SC_START || str_len(&scanner->buffer) != 0) {
+        return false;
+    }
+    chunk_join(chunk);
+    token_run_t* run = &chunk->run;
+    const char* pos = scanner->source.pos;
+
+    size_t first;
+    if (pos == chunk->start) {
+        first = 0;
+    } else {
+        while (chunk->checked < run->count && run->ends[chunk->checked] < pos) {
+            chunk->checked++;
+        }
+        if (chunk->checked == run->count || run->ends[chunk->checked] != pos) {
+            return false;
+        }
+        first = chunk->checked + 1;
+    }
+    if (first >= run->count) {
+        return false;
+    }
+
+    const uint32_t base = chunk->start - scanner->source.data;
+    for (size_t i = first; i < run->count; i++) {
+        token_t token = run->tokens[i];
+        if (token.type == TOK_VAR || token.type == TOK_FUN_NAME || token.type == TOK_STR_LIT) {
+            token = token_intern(&token, chunk->start);
+        }
+        token.offset += base;
+        token_run_push(out, token, run->ends[i]);
+        // Invalid string literal stops scanning (same as in the real scanner)
+        if (token.type == TOK_ERROR) {
+            scanner->source.pos = run->ends[i];
+            return true;
+        }
+    }
+
+    // Real scanner continues after the last token
+    scanner->source.pos = run->ends[run->count - 1];
+    return true;
+}
+
+token_t* scanner_lex_parallel(scanner_t* scanner, unsigned threads, size_t* count) {
+    const char* input = scanner->source.pos;
+    const char* input_end = scanner->source.end;
+    const size_t len = input_end - input;
+    if (threads > len / SCANNER_PARALLEL_MIN_CHUNK) {
+        threads = len / SCANNER_PARALLEL_MIN_CHUNK;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // Split input at line starts (string literals can't contain newline, only comment can)
+    chunk_t* chunks = calloc(threads, sizeof(chunk_t));
+    if (chunks == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    size_t chunk_count = 1;
+    chunks[0].start = input;
+    for (size_t i = 1; i < threads; i++) {
+        const char* split = input + len / threads * i;
+        const char* newline = memchr(split, '\n', input_end - split);
+        if (newline == NULL || newline + 1 == input_end) {
+            break;
+        }
+        if (newline + 1 > chunks[chunk_count - 1].start) {
+            chunks[chunk_count++].start = newline + 1;
+        }
+    }
+    for (size_t i = 0; i < chunk_count; i++) {
+        chunks[i].end = i + 1 < chunk_count ? chunks[i + 1].start : input_end;
+        chunks[i].input_end = input_end;
+    }
+
+    // Fast-skip kernels are selected on first use, do it before workers start
+    skip_blank(input, input);
+    // First chunk is lexed directly by the real scanner
+    chunks[0].joined = true;
+    for (size_t i = 1; i < chunk_count; i++) {
+        if (pthread_create(&chunks[i].thread, NULL, chunk_lex, &chunks[i]) != 0) {
+            error_exit(ERR_INTERNAL);
+        }
+    }
+
+    token_run_t out = {0};
+    size_t current = 0;
+    while (true) {
+        // Last chunk starting before current position
+        while (current + 1 < chunk_count && chunks[current + 1].start <= scanner->source.pos) {
+            current++;
+        }
+        if (current > 0 && chunk_stitch(scanner, &chunks[current], &out)) {
+            if (is_last_token(&out.tokens[out.count - 1])) {
+                break;
+            }
+            continue;
+        }
+
+        // Chunk boundary was inside a comment (or the scanner is still in the first chunk)
+        token_t token;
+        scanner_fill(scanner, &token, 1);
+        token_run_push(&out, token, scanner->source.pos);
+        if (is_last_token(&token)) {
+            break;
+        }
+    }
+
+    for (size_t i = 1; i < chunk_count; i++) {
+        chunk_join(&chunks[i]);
+        free(chunks[i].run.tokens);
+        free(chunks[i].run.ends);
+    }
+    free(chunks);
+    free(out.ends);
+    *count = out.count;
+    return out.tokens;
+}
@@ -0,0 +1,39 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file scanner_parallel.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for parallel speculative lexing of large sources
+ */
+
+#ifndef __SCANNER_PARALLEL_H__
+#define __SCANNER_PARALLEL_H__
+
+#include "scanner.h"
+#include "token.h"
+
+// Sources smaller than this are always lexed by a single thread
+#ifndef SCANNER_PARALLEL_MIN_CHUNK
+#define SCANNER_PARALLEL_MIN_CHUNK (1 << 16)
+#endif
+
+/**
+ * @brief Lex whole source using multiple threads
+ *
+ * Source is split into chunks at line starts, every chunk is lexed speculatively (as if it started
+ * in SC_START) on its own thread and the results are stitched together. Wherever the real scanner
+ * doesn't reach a chunk in SC_START exactly at one of its speculative token boundaries (chunk
+ * started inside a comment), the tokens are lexed again serially. Result is always the same as from
+ * calling scanner_fill on the scanner until TOK_EOF or TOK_ERROR, including token offsets.
+ *
+ * @param scanner Scanner that hasn't scanned anything yet (it is at the end of the input afterwards)
+ * @param threads Number of threads (including the calling one)
+ * @param count Number of returned tokens
+ * @return Tokens (last one is TOK_EOF or TOK_ERROR), array and tokens are owned by the caller
+ */
+token_t* scanner_lex_parallel(scanner_t* scanner, unsigned threads, size_t* count);
+
+#endif  // __SCANNER_PARALLEL_H__
@@ -0,0 +1,276 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file skip.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Fast-skip kernels used by the scanner (scalar, SSE2 and AVX2)
+ */
+
+#include "skip.h"
+
+// Vector kernels are only built for x86 with GCC compatible compiler
+#if !defined(SKIP_SCALAR_ONLY) && defined(__GNUC__) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define SKIP_HAVE_SSE2
+#define SKIP_HAVE_AVX2
+#include <immintrin.h>
+// AVX2 kernels are compiled for AVX2 even if the rest of the build is not
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+typedef const char* (*skip_fn_t)(const char* p, const char* end);
+
+/**
+ * @brief Check if character is blank (whitespace except newline)
+ */
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Check if character ends ordinary part of string literal
+ */
+static inline bool is_string_stop(char c) {
+    return c == '"' || c == '\\' || (unsigned char)c < 32;
+}
+
+static const char* skip_blank_scalar(const char* p, const char* end) {
+    while (p < end && is_blank(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static const char* skip_to_newline_scalar(const char* p, const char* end) {
+    while (p < end && *p != '\n') {
+        p++;
+    }
+    return p;
+}
+
+static const char* skip_to_star_scalar(const char* p, const char* end) {
+    while (p < end && *p != '*') {
+        p++;
+    }
+    return p;
+}
+
+static const char* skip_string_body_scalar(const char* p, const char* end) {
+    while (p < end && !is_string_stop(*p)) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef SKIP_HAVE_SSE2
+
+static const char* skip_blank_sse2(const char* p, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i vt = _mm_set1_epi8('\v');
+    const __m128i ff = _mm_set1_epi8('\f');
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(x, cr), _mm_cmpeq_epi8(x, vt)));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(x, ff));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(m) & 0xFFFF;
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return skip_blank_scalar(p, end);
+}
+
+static const char* skip_to_newline_sse2(const char* p, const char* end) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, nl));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return skip_to_newline_scalar(p, end);
+}
+
+static const char* skip_to_star_sse2(const char* p, const char* end) {
+    const __m128i star = _mm_set1_epi8('*');
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, star));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return skip_to_star_scalar(p, end);
+}
+
+static const char* skip_string_body_sse2(const char* p, const char* end) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(31);
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        // Unsigned x <= 31 is the same as max(x, 31) == 31
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));
+        unsigned mask = _mm_movemask_epi8(m);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return skip_string_body_scalar(p, end);
+}
+
+#endif  // SKIP_HAVE_SSE2
+
+#ifdef SKIP_HAVE_AVX2
+
+AVX2_TARGET static const char* skip_blank_avx2(const char* p, const char* end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i vt = _mm256_set1_epi8('\v');
+    const __m256i ff = _mm256_set1_epi8('\f');
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(x, space), _mm256_cmpeq_epi8(x, tab));
+        m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(x, cr), _mm256_cmpeq_epi8(x, vt)));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, ff));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(m);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return skip_blank_sse2(p, end);
+}
+
+AVX2_TARGET static const char* skip_to_newline_avx2(const char* p, const char* end) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, nl));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return skip_to_newline_sse2(p, end);
+}
+
+AVX2_TARGET static const char* skip_to_star_avx2(const char* p, const char* end) {
+    const __m256i star = _mm256_set1_epi8('*');
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, star));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return skip_to_star_sse2(p, end);
+}
+
+AVX2_TARGET static const char* skip_string_body_avx2(const char* p, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i ctrl = _mm256_set1_epi8(31);
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(x, ctrl), ctrl));
+        unsigned mask = _mm256_movemask_epi8(m);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return skip_string_body_sse2(p, end);
+}
+
+#endif  // SKIP_HAVE_AVX2
+
+// Currently selected kernels (resolved on first use)
+static skip_fn_t skip_blank_fn = NULL;
+static skip_fn_t skip_to_newline_fn = NULL;
+static skip_fn_t skip_to_star_fn = NULL;
+static skip_fn_t skip_string_body_fn = NULL;
+
+bool skip_use(skip_impl_t impl) {
+    switch (impl) {
+        case SKIP_IMPL_SCALAR:
+            skip_blank_fn = skip_blank_scalar;
+            skip_to_newline_fn = skip_to_newline_scalar;
+            skip_to_star_fn = skip_to_star_scalar;
+            skip_string_body_fn = skip_string_body_scalar;
+            return true;
+#ifdef SKIP_HAVE_SSE2
+        case SKIP_IMPL_SSE2:
+            skip_blank_fn = skip_blank_sse2;
+            skip_to_newline_fn = skip_to_newline_sse2;
+            skip_to_star_fn = skip_to_star_sse2;
+            skip_string_body_fn = skip_string_body_sse2;
+            return true;
+#endif
+#ifdef SKIP_HAVE_AVX2
+        case SKIP_IMPL_AVX2:
+            if (!__builtin_cpu_supports("avx2")) {
+                return false;
+            }
+            skip_blank_fn = skip_blank_avx2;
+            skip_to_newline_fn = skip_to_newline_avx2;
+            skip_to_star_fn = skip_to_star_avx2;
+            skip_string_body_fn = skip_string_body_avx2;
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Select best available kernels
+ */
+static void skip_init() {
+    if (!skip_use(SKIP_IMPL_AVX2) && !skip_use(SKIP_IMPL_SSE2)) {
+        skip_use(SKIP_IMPL_SCALAR);
+    }
+}
+
+const char* skip_blank(const char* p, const char* end) {
+    if (skip_blank_fn == NULL) {
+        skip_init();
+    }
+    return skip_blank_fn(p, end);
+}
+
+const char* skip_to_newline(const char* p, const char* end) {
+    if (skip_to_newline_fn == NULL) {
+        skip_init();
+    }
+    return skip_to_newline_fn(p, end);
+}
+
+const char* skip_to_star(const char* p, const char* end) {
+    if (skip_to_star_fn == NULL) {
+        skip_init();
+    }
+    return skip_to_star_fn(p, end);
+}
+
+const char* skip_string_body(const char* p, const char* end) {
+    if (skip_string_body_fn == NULL) {
+        skip_init();
+    }
+    return skip_string_body_fn(p, end);
+}
@@ -0,0 +1,70 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file skip.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for fast-skip kernels used by the scanner
+ */
+
+#ifndef __SKIP_H__
+#define __SKIP_H__
+
+#include <stdbool.h>
+
+/**
+ * @brief Available kernel implementations
+ */
+typedef enum {
+    SKIP_IMPL_SCALAR,  // Plain C loop (always available)
+    SKIP_IMPL_SSE2,    // 16 bytes per step
+    SKIP_IMPL_AVX2,    // 32 bytes per step (selected at runtime if CPU supports it)
+} skip_impl_t;
+
+/**
+ * @brief Select kernel implementation (best available one is used by default)
+ *
+ * @param impl Implementation
+ * @return false if implementation is not supported on this machine / build
+ */
+bool skip_use(skip_impl_t impl);
+
+/**
+ * @brief Skip blanks (space, \t, \r, \v, \f), newline is not skipped
+ *
+ * @param p Current position
+ * @param end End of input
+ * @return First position which is not blank (or end)
+ */
+const char* skip_blank(const char* p, const char* end);
+
+/**
+ * @brief Skip to the next newline
+ *
+ * @param p Current position
+ * @param end End of input
+ * @return Position of next \n (or end)
+ */
+const char* skip_to_newline(const char* p, const char* end);
+
+/**
+ * @brief Skip to the next star (possible end of multiline comment)
+ *
+ * @param p Current position
+ * @param end End of input
+ * @return Position of next * (or end)
+ */
+const char* skip_to_star(const char* p, const char* end);
+
+/**
+ * @brief Skip ordinary characters of string literal body
+ *
+ * @param p Current position
+ * @param end End of input
+ * @return Position of next ", \ or control character (or end)
+ */
+const char* skip_string_body(const char* p, const char* end);
+
+#endif  // __SKIP_H__
@@ -0,0 +1,169 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file source.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Memory-resident source input (mmap or chunked reads)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "source.h"
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "error.h"
+#include "skip.h"
+
+// Size of the first chunk when reading from pipe (doubles with every resize)
+#define CHUNK_SIZE (1 << 16)
+
+source_t source_new_from_buffer(const char* buf, size_t len) {
+    return (source_t){.data = buf, .pos = buf, .end = buf + len};
+}
+
+/**
+ * @brief Read whole stream into heap buffer (used for pipes and terminals)
+ *
+ * @param fd File descriptor
+ * @return New source owning the buffer
+ */
+static source_t source_read_chunked(int fd) {
+    size_t size = CHUNK_SIZE;
+    size_t len = 0;
+    char* buf = malloc(size);
+    if (buf == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+
+    while (true) {
+        // Enlarge buffer if needed
+        if (len == size) {
+            char* new_buf = realloc(buf, size * 2);
+            if (new_buf == NULL) {
+                error_exit(ERR_INTERNAL);
+            }
+            buf = new_buf;
+            size *= 2;
+        }
+
+        ssize_t n = read(fd, buf + len, size - len);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_exit(ERR_INTERNAL);
+        }
+        len += n;
+    }
+
+    source_t source = source_new_from_buffer(buf, len);
+    source.owned = buf;
+    return source;
+}
+
+source_t source_new_from_fd(int fd) {
+    struct stat st;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+
+    // Only regular non-empty files can be mapped
+    if (offset < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        return source_read_chunked(fd);
+    }
+
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return source_read_chunked(fd);
+    }
+
+    // We are scanning front to back
+    posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    if (offset > st.st_size) {
+        offset = st.st_size;
+    }
+    source_t source = source_new_from_buffer((char*)map + offset, st.st_size - offset);
+    source.map = map;
+    source.map_len = st.st_size;
+    return source;
+}
+
+source_t source_new_from_file(FILE* input) {
+    // Make sure pending writes reach the file and find out the logical position
+    fflush(input);
+    off_t offset = ftello(input);
+
+    int fd = fileno(input);
+    if (offset >= 0) {
+        lseek(fd, offset, SEEK_SET);
+    }
+    return source_new_from_fd(fd);
+}
+
+/**
+ * @brief Build index of line starts
+ *
+ * @param source Source
+ */
+static void source_index_lines(source_t* source) {
+    size_t size = 1024;
+    size_t* lines = malloc(size * sizeof(size_t));
+    if (lines == NULL) {
+        error_exit(ERR_INTERNAL);
+    }
+    size_t count = 0;
+    lines[count++] = 0;
+    // Newlines are found with the same vector kernel the scanner uses for line comments
+    const char* p = source->data;
+    while ((p = skip_to_newline(p, source->end)) < source->end) {
+        p++;
+        if (count == size) {
+            size *= 2;
+            size_t* new_lines = realloc(lines, size * sizeof(size_t));
+            if (new_lines == NULL) {
+                error_exit(ERR_INTERNAL);
+            }
+            lines = new_lines;
+        }
+        lines[count++] = p - source->data;
+    }
+    source->lines = lines;
+    source->line_count = count;
+}
+
+void source_location(source_t* source, uint32_t offset, size_t* line_nr, size_t* col_nr) {
+    if (source->lines == NULL) {
+        source_index_lines(source);
+    }
+    const size_t last = offset > 0 ? offset - 1 : 0;
+    // Find last line starting before the character (lines[low] <= last < lines[high])
+    size_t low = 0, high = source->line_count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (source->lines[mid] <= last) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    *line_nr = low + 1;
+    *col_nr = last - source->lines[low] + 1;
+}
+
+void source_free(source_t* source) {
+    if (source->map != NULL) {
+        munmap(source->map, source->map_len);
+    }
+    free(source->owned);
+    free(source->lines);
+    // Reset values just to be sure
+    *source = (source_t){0};
+}
@@ -0,0 +1,108 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file source.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Header file for memory-resident source input
+ */
+
+#ifndef __SOURCE_H__
+#define __SOURCE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Whole input is kept in memory, scanner walks it with a raw pointer
+typedef struct {
+    const char* data;  // Start of the input
+    const char* pos;   // Current read position
+    const char* end;   // One past the last byte of the input
+    void* map;         // Start of the mapping (NULL if not mapped)
+    size_t map_len;    // Length of the mapping
+    char* owned;       // Heap buffer owned by the source (NULL if not owned)
+    size_t* lines;     // Offsets of line starts (built on first source_location call)
+    size_t line_count; // Number of lines
+} source_t;
+
+/**
+ * @brief Create source from existing buffer (buffer is borrowed, not copied)
+ *
+ * @param buf Buffer with source code
+ * @param len Length of the buffer
+ * @return New source
+ */
+source_t source_new_from_buffer(const char* buf, size_t len);
+
+/**
+ * @brief Create source from file descriptor
+ * Regular files are mapped into memory, pipes are read in large chunks
+ *
+ * @param fd File descriptor (reading starts at its current offset)
+ * @return New source
+ */
+source_t source_new_from_fd(int fd);
+
+/**
+ * @brief Create source from stdio stream
+ *
+ * @param input Input stream (reading starts at its current position)
+ * @return New source
+ */
+source_t source_new_from_file(FILE* input);
+
+/**
+ * @brief Free existing source
+ *
+ * @param source Source
+ */
+void source_free(source_t* source);
+
+/**
+ * @brief Get line and column of token (line index is built when this is called for the first time)
+ *
+ * @param source Source
+ * @param offset Offset right after the last character of the token
+ * @param line_nr Line number (from 1)
+ * @param col_nr Column of the last character of the token (from 1)
+ */
+void source_location(source_t* source, uint32_t offset, size_t* line_nr, size_t* col_nr);
+
+/**
+ * @brief Get next character and advance
+ *
+ * @param source Source
+ * @return Next character or EOF
+ */
+static inline int source_getc(source_t* source) {
+    return source->pos < source->end ? (unsigned char)*source->pos++ : EOF;
+}
+
+/**
+ * @brief Return last read character back (EOF is ignored the same way as ungetc does)
+ *
+ * @param source Source
+ * @param c Character returned by source_getc
+ */
+static inline void source_ungetc(source_t* source, int c) {
+    if (c != EOF) {
+        source->pos--;
+    }
+}
+
+/**
+ * @brief Look at character k positions ahead without consuming anything
+ *
+ * @param source Source
+ * @param k Lookahead distance (0 is the next character)
+ * @return Character or EOF
+ */
+static inline int source_peek(source_t* source, size_t k) {
+    return (size_t)(source->end - source->pos) > k ? (unsigned char)source->pos[k] : EOF;
+}
+
+#endif  // __SOURCE_H__
@@ -11,149 +11,100 @@
 
 #include "stack.h"
 #include <stdio.h>
+#include <string.h>
 #include "error.h"
 #include "token.h"
 
 #define DEFAULT_SIZE 8
 
-stack_t stack_new() {
+stack_t stack_new(arena_t* arena) {
     // Create new struct
     stack_t stack = {
-        .tokens = malloc(DEFAULT_SIZE * sizeof(token_term_t*)),
+        .items = arena_alloc(arena, DEFAULT_SIZE * sizeof(stack_item_t)),
         .size = DEFAULT_SIZE,
         .len = 0,
+        .top_terminal = -1,
+        .arena = arena,
     };
 
-    // Check if malloc failed
-    if (stack.tokens == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
-
     return stack;
 }
 
 void stack_free(stack_t* stack) {
-    // Free the stack
-    for (int i = 0; i < stack->len; i++) {
-        token_term_free(stack->tokens[i]);
-        stack->tokens[i] = NULL;
-    }
-    free(stack->tokens);
-    // Reset values just to be sure
-    stack->tokens = NULL;
+    // Items are released with the arena
+    stack->items = NULL;
     stack->len = 0;
     stack->size = 0;
+    stack->top_terminal = -1;
 }
 
-void stack_empty(stack_t* stack) {
-    // Just set length to 0 (this is correct)
-    stack->len = 0;
-}
-
-void resize_stack(stack_t* stack) {
-    token_term_t** new_tokens = realloc(stack->tokens, stack->size * 2 * sizeof(token_term_t*));
-    if (new_tokens == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
-    stack->tokens = new_tokens;
-    stack->size *= 2;
-}
-
-void stack_push(stack_t* stack, token_term_t* token) {
-    // Enlarge buffer if needed
-    if (stack->len + 1 >= stack->size) {
-        resize_stack(stack);
+/**
+ * @brief Push item on the stack (buffer is enlarged if needed)
+ *
+ * @param stack Stack
+ * @param item Item
+ */
+static void stack_push(stack_t* stack, stack_item_t item) {
+    if (stack->len == stack->size) {
+        stack_item_t* items = arena_alloc(stack->arena, stack->size * 2 * sizeof(stack_item_t));
+        memcpy(items, stack->items, stack->size * sizeof(stack_item_t));
+        stack->items = items;
+        stack->size *= 2;
     }
-
-    // Add token to the stack
-    stack->tokens[stack->len] = token;
-    stack->len++;
+    stack->items[stack->len++] = item;
 }
 
-token_term_t* stack_pop(stack_t* stack) {
-    // Check if stack is empty
-    if (stack->len == 0) {
-        error_exit(ERR_SYN);
+void stack_shift(stack_t* stack, token_t token, bool handle) {
+    bool handle_here = false;
+    if (handle) {
+        // Handle starts right after the topmost terminal
+        if (stack->top_terminal == -1) {
+            error_exit(ERR_SYN);
+        }
+        if (stack->top_terminal + 1 < stack->len) {
+            stack->items[stack->top_terminal + 1].handle = true;
+        } else {
+            handle_here = true;
+        }
     }
-
-    // Get token from the stack
-    token_term_t* token = stack->tokens[stack->len - 1];
-    stack->len--;
-
-    return token;
+    stack_push(stack, (stack_item_t){.token = token,
+                                     .below = stack->top_terminal,
+                                     .terminal = true,
+                                     .handle = handle_here});
+    stack->top_terminal = stack->len - 1;
 }
 
-token_term_t* stack_top(stack_t* stack) {
-    // Check if stack is empty
-    if (stack->len == 0) {
+token_t* stack_top_terminal(stack_t* stack) {
+    if (stack->top_terminal == -1) {
         error_exit(ERR_SYN);
     }
-
-    // Get token from the stack
-    token_term_t* token = stack->tokens[stack->len - 1];
-
-    return token;
+    return &stack->items[stack->top_terminal].token;
 }
 
-token_term_t* stack_pop_terminal(stack_t* stack) {
+stack_item_t* stack_top(stack_t* stack) {
     // Check if stack is empty
     if (stack->len == 0) {
         error_exit(ERR_SYN);
     }
-    token_term_t* token = NULL;
-
-    for (int i = 1; i <= stack->len; i++) {
-        token = stack->tokens[stack->len - i];
-        if (token->terminal) {
-            stack->len--;
-            return token;
-        }
-    }
-    error_exit(ERR_SYN);
-    return token;
+    return &stack->items[stack->len - 1];
 }
 
-token_term_t* stack_top_terminal(stack_t* stack) {
-    // Check if stack is empty
-    if (stack->len == 0) {
-        error_exit(ERR_SYN);
-    }
-    token_term_t* token = NULL;
-
-    for (int i = 1; i <= stack->len; i++) {
-        token = stack->tokens[stack->len - i];
-        if (token->terminal) {
-            return token;
+int stack_handle(stack_t* stack) {
+    for (int i = stack->len - 1; i >= 0; i--) {
+        if (stack->items[i].handle) {
+            return i;
         }
     }
     error_exit(ERR_SYN);
-    return token;
 }
 
-void stack_push_after_terminal(stack_t* stack) {
-    // Check if stack is empty
-    if (stack->len == 0) {
-        error_exit(ERR_SYN);
-    }
-    token_term_t* token;
-
-    for (int i = 1; i <= stack->len; i++) {
-        token = stack->tokens[stack->len - i];
-        if (token->terminal) {
-            if (stack->len + 1 >= stack->size) {
-                resize_stack(stack);
-            }
-            for (int j = 1; j < i + 1; j++) {
-                stack->tokens[stack->len - j + 1] = stack->tokens[stack->len - j];
-            }
-            stack->tokens[stack->len - i + 1] =
-                token_term_new(token_new(TOK_HANDLE_START, 0, 0), false);
-            stack->len++;
-
-            return;
-        }
+void stack_reduce(stack_t* stack, int start, token_t token) {
+    stack->len = start;
+    // Terminals of the handle were removed
+    while (stack->top_terminal >= start) {
+        stack->top_terminal = stack->items[stack->top_terminal].below;
     }
-    error_exit(ERR_SYN);
+    stack_push(stack, (stack_item_t){.token = token, .terminal = false, .handle = false});
 }
 
 void stack_pprint(stack_t* stack) {
@@ -162,7 +113,8 @@ void stack_pprint(stack_t* stack) {
         return;
     }
     for (int i = 0; i < stack->len; i++) {
-        fprintf(stderr, "%d[%d]: %s\n", i, stack->tokens[i]->terminal,
-                token_to_string(stack->tokens[i]->value.type));
+        stack_item_t* item = &stack->items[i];
+        fprintf(stderr, "%d[%d]%s: %s\n", i, item->terminal, item->handle ? " <" : "",
+                token_to_string(item->token.type));
     }
 }
@@ -7,25 +7,41 @@
  * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
  * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
  * @brief Declarations of helper functions for working with stack
+ *
+ * Stack of the precedence analysis is a flat array. Terminals are stored by value, nonterminal
+ * keeps only the token it was reduced from (the expression itself goes to postfix buffer), start
+ * of a handle is a flag of the item and the index of the topmost terminal is tracked, so no
+ * operation has to search the stack.
  */
 
 #ifndef __STACK_H__
 #define __STACK_H__
 
-#include "token_term.h"
+#include "arena.h"
+#include "token.h"
+
+typedef struct {
+    token_t token;  // Terminal or token the nonterminal was reduced from (operand or operator)
+    int below;      // Index of the terminal below this one (only for terminals)
+    bool terminal;  // Is item terminal?
+    bool handle;    // Does handle start at this item?
+} stack_item_t;
 
 typedef struct {
-    token_term_t** tokens;
+    stack_item_t* items;
     int len;
     int size;
+    int top_terminal;  // Index of the topmost terminal (-1 if there is none)
+    arena_t* arena;    // Arena of the expression (items are allocated from it)
 } stack_t;
 
 /**
  * @brief Initialize new stack struct
  *
+ * @param arena Arena of the expression
  * @return New stack_t
  */
-stack_t stack_new();
+stack_t stack_new(arena_t* arena);
 
 /**
  * @brief Frees stack
@@ -35,73 +51,52 @@ stack_t stack_new();
 void stack_free(stack_t* stack);
 
 /**
- * @brief Removes all elements from stack (does not free stack)
+ * @brief Pushes terminal on the stack
  *
  * @param stack Stack
+ * @param token Terminal
+ * @param handle Whether handle starts right after the topmost terminal (shift with <)
  */
-void stack_empty(stack_t* stack);
-
-/**
- * @brief Pushes value on the stack
- *
- * @param stack to be pushed to, token to be pushed
- */
-void stack_push(stack_t* stack, token_term_t* token);
+void stack_shift(stack_t* stack, token_t token, bool handle);
 
 /**
- * @brief Removes and returns the top of the stack
- *
- * @param stack to be popped from
+ * @brief Returns terminal closest to the top of the stack
  *
- * @return token_term_t from top of the stack
+ * @param stack Stack
+ * @return Terminal
  */
-token_term_t* stack_pop(stack_t* stack);
+token_t* stack_top_terminal(stack_t* stack);
 
 /**
  * @brief Returns top of the stack
  *
- * @param stack to be popped from
- *
- * @return token_term_t from top of the stack
- */
-token_term_t* stack_top(stack_t* stack);
-
-/**
- * @brief Pretty prints stack
- *
- * @param stack to be printed
+ * @param stack Stack
+ * @return Item on top of the stack
  */
-void stack_pprint(stack_t* stack);
+stack_item_t* stack_top(stack_t* stack);
 
 /**
- * @brief Returns terminal closest to the top of the stack and removes it
+ * @brief Finds start of the topmost handle
  *
- * @param stack to be popped from
- *
- * @return token_term_t from top of the stack
+ * @param stack Stack
+ * @return Index of the first item of the handle
  */
-token_term_t* stack_pop_terminal(stack_t* stack);
+int stack_handle(stack_t* stack);
 
 /**
- * @brief Returns terminal closest to the top of the stack
- *
- * @param stack to be popped from
+ * @brief Replaces items from the start of handle to the top by nonterminal
  *
- * @return token_term_t from top of the stack
+ * @param stack Stack
+ * @param start Index of the first item of the handle
+ * @param token Token the nonterminal was reduced from
  */
-token_term_t* stack_top_terminal(stack_t* stack);
+void stack_reduce(stack_t* stack, int start, token_t token);
 
 /**
- * @brief Pushes start_handle after the terminal closest to the top
+ * @brief Pretty prints stack
  *
- * @param stack to be pushed to
+ * @param stack to be printed
  */
-void stack_push_after_terminal(stack_t* stack);
+void stack_pprint(stack_t* stack);
 
-/**
- * @brief Resizes stack to twice the size
- *
- * @param stack to be resized
- */
-void resize_stack(stack_t* stack);
 #endif  // __STACK_H__
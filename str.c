@@ -10,104 +10,142 @@
  */
 
 #include "str.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "error.h"
 
-// Default string size (including \0)
-#define DEFAULT_SIZE 8
+// Kind byte has to be at the same place in both layouts
+_Static_assert(sizeof(str_t) == STR_SMALL_MAX + 2, "str_t has unexpected size");
+_Static_assert(offsetof(str_t, large.kind) == offsetof(str_t, small.kind),
+               "kind of short and long string differ");
 
-str_t str_new() {
-    // Create new struct
-    str_t str = {
-        .val = malloc(DEFAULT_SIZE),
-        .size = DEFAULT_SIZE,
-        .len = 0,
-    };
-
-    // Check if malloc failed
-    if (str.val == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+// Heap buffer size for strings which don't fit inline anymore (including \0)
+#define DEFAULT_SIZE (2 * (STR_SMALL_MAX + 1))
 
-    // Make string valid
-    str.val[0] = '\0';
+/**
+ * @brief Set length of string and terminate it
+ *
+ * @param str String (not view)
+ * @param len New length
+ */
+static inline void str_set_len(str_t* str, size_t len) {
+    if (str->small.kind <= STR_SMALL_MAX) {
+        str->small.kind = len;
+    } else {
+        str->large.len = len;
+    }
+    str_val(str)[len] = '\0';
+}
 
-    return str;
+str_t str_new() {
+    // Empty inline string (all bytes zero)
+    return (str_t){.small = {.kind = 0}};
 }
 
 str_t str_new_from_str(str_t* str) {
-    // Create new struct
-    str_t new_str = {.val = malloc(str->len + 1),  // Just enough to fit
-                     .size = str->len + 1,
-                     .len = str->len};
+    str_t new_str = str_new();
+    str_add_str(&new_str, str);
+    return new_str;
+}
 
-    // Check if malloc failed
-    if (new_str.val == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+str_t str_new_view(const char* val, size_t len) {
+    return (str_t){.large = {.ptr = (char*)val, .len = len, .kind = STR_VIEW}};
+}
 
-    // Copy data to new string
-    strcpy(new_str.val, str->val);
+bool str_eq(str_t* str, str_t* str2) {
+    return str_len(str) == str_len(str2) && memcmp(str_val(str), str_val(str2), str_len(str)) == 0;
+}
 
-    return new_str;
+bool str_eq_cstr(str_t* str, const char* cstr) {
+    return strlen(cstr) == str_len(str) && memcmp(str_val(str), cstr, str_len(str)) == 0;
 }
 
 void str_free(str_t* str) {
-    // Free the string
-    free(str->val);
+    // Free the string (views and short strings don't own anything)
+    if (str->small.kind == STR_HEAP) {
+        free(str->large.ptr);
+    }
     // Reset values just to be sure
-    str->val = NULL;
-    str->len = 0;
-    str->size = 0;
+    *str = str_new();
 }
 
-void str_add_char(str_t* str, char c) {
-    // Enlarge buffer if needed
-    if (str->len + 1 >= str->size) {
-        char* new_val = realloc(str->val, str->size * 2);
+void str_reserve(str_t* str, size_t n) {
+    const size_t len = str_len(str);
+    const uint8_t kind = str->small.kind;
+    if ((kind <= STR_SMALL_MAX && len + n <= STR_SMALL_MAX) ||
+        (kind == STR_HEAP && len + n + 1 <= str->large.size)) {
+        return;
+    }
+
+    // Enlarge buffer (doubling keeps appending linear)
+    size_t new_size = kind == STR_HEAP ? str->large.size * 2 : DEFAULT_SIZE;
+    while (len + n + 1 > new_size) {
+        new_size *= 2;
+    }
+    if (new_size > UINT32_MAX) {
+        error_exit(ERR_INTERNAL);
+    }
+    char* new_val;
+    if (kind == STR_HEAP) {
+        new_val = realloc(str->large.ptr, new_size);
         if (new_val == NULL) {
             error_exit(ERR_INTERNAL);
         }
-        str->val = new_val;
-        str->size *= 2;
-    }
-
-    str->val[str->len] = c;
-    str->len++;
-    str->val[str->len] = '\0';
-}
-
-void str_add_cstr(str_t* str, char* cstr) {
-    size_t len = strlen(cstr);
-    if (str->len + len + 1 >= str->size) {
-        char* new_val = realloc(str->val, str->size + len);
+    } else {
+        // Inline characters or view are moved to heap
+        new_val = malloc(new_size);
         if (new_val == NULL) {
             error_exit(ERR_INTERNAL);
         }
-        str->val = new_val;
-        str->size += len;
+        memcpy(new_val, str_val(str), len);
+        new_val[len] = '\0';
     }
-    str->len += len;
-    strcat(str->val, cstr);
+    str->large.ptr = new_val;
+    str->large.len = len;
+    str->large.size = new_size;
+    str->large.kind = STR_HEAP;
+}
+
+void str_add_char(str_t* str, char c) {
+    str_reserve(str, 1);
+    const size_t len = str_len(str);
+    str_val(str)[len] = c;
+    str_set_len(str, len + 1);
+}
+
+void str_add_cstr(str_t* str, const char* cstr) {
+    str_add_cstr_n(str, cstr, strlen(cstr));
+}
+
+void str_add_cstr_n(str_t* str, const char* cstr, size_t n) {
+    str_reserve(str, n);
+    // Append at known length (no need to look for the end)
+    const size_t len = str_len(str);
+    memcpy(str_val(str) + len, cstr, n);
+    str_set_len(str, len + n);
 }
 
 void str_add_str(str_t* str, str_t* str2) {
-    str_add_cstr(str, str2->val);
+    str_add_cstr_n(str, str_val(str2), str_len(str2));
 }
 
 void str_add_int(str_t* str, int i) {
     char buf[32];
-    sprintf(buf, "%d", i);
-    str_add_cstr(str, buf);
+    int len = snprintf(buf, sizeof(buf), "%d", i);
+    str_add_cstr_n(str, buf, len);
 }
 
 void str_clear(str_t* str) {
-    str->val[0] = '\0';
-    str->len = 0;
+    if (str->small.kind == STR_HEAP) {
+        // Keep the buffer for reuse
+        str_set_len(str, 0);
+    } else {
+        *str = str_new();
+    }
 }
 
 void str_print(str_t* str) {
-    printf("%s", str->val);
+    printf("%.*s", (int)str_len(str), str_val(str));
 }
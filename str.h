@@ -13,17 +13,55 @@
 #define __STR_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
-// String
-typedef struct {
-    char* val;    // Actual string
-    size_t len;   // Length
-    size_t size;  // Buffer size
+// Longest string stored inline (without heap allocation)
+#define STR_SMALL_MAX 22
+// Kind of long string (kind of short string is its length)
+#define STR_HEAP 0xFE
+#define STR_VIEW 0xFF
+
+// String (short strings are stored inline, view is read-only reference into someone else's memory
+// which is not null terminated)
+// Heap buffer grows geometrically, so building a string by appending is linear in its length
+// Fields shouldn't be accessed directly, use str_val and str_len
+typedef union {
+    struct {
+        char* ptr;      // Heap buffer or viewed characters
+        size_t len;     // Length
+        uint32_t size;  // Heap buffer size
+        char pad[3];    // Unused
+        uint8_t kind;   // STR_HEAP or STR_VIEW (same byte as small.kind)
+    } large;
+    struct {
+        char val[STR_SMALL_MAX + 1];  // Characters (null terminated)
+        uint8_t kind;                 // Length
+    } small;
 } str_t;
 
 /**
- * @brief Initialize new empty string
+ * @brief Get characters of string
+ *
+ * @param str String
+ * @return Characters (null terminated unless the string is view)
+ */
+static inline char* str_val(str_t* str) {
+    return str->small.kind <= STR_SMALL_MAX ? str->small.val : str->large.ptr;
+}
+
+/**
+ * @brief Get length of string
+ *
+ * @param str String
+ * @return Length
+ */
+static inline size_t str_len(const str_t* str) {
+    return str->small.kind <= STR_SMALL_MAX ? str->small.kind : str->large.len;
+}
+
+/**
+ * @brief Initialize new empty string (nothing is allocated)
  *
  * @return Initiazed string
  */
@@ -38,12 +76,47 @@ str_t str_new();
 str_t str_new_from_str(str_t* str);
 
 /**
- * @brief Free existing string
+ * @brief Initialize read-only view of existing characters (nothing is copied or allocated)
+ *
+ * @param val Characters (have to outlive the view)
+ * @param len Number of characters
+ * @return View
+ */
+str_t str_new_view(const char* val, size_t len);
+
+/**
+ * @brief Check if two strings are equal
+ *
+ * @param str First string (can be view)
+ * @param str2 Second string (can be view)
+ * @return true if strings are equal
+ */
+bool str_eq(str_t* str, str_t* str2);
+
+/**
+ * @brief Check if string is equal to c-string
+ *
+ * @param str String (can be view)
+ * @param cstr C-String
+ * @return true if strings are equal
+ */
+bool str_eq_cstr(str_t* str, const char* cstr);
+
+/**
+ * @brief Free existing string (views are only reset)
  *
  * @param str String to be freed
  */
 void str_free(str_t* str);
 
+/**
+ * @brief Make sure that n more characters fit into string without reallocation (view is copied)
+ *
+ * @param str String
+ * @param n Number of characters which will be added
+ */
+void str_reserve(str_t* str, size_t n);
+
 /**
  * @brief Add character to string
  *
@@ -57,7 +130,16 @@ void str_add_char(str_t* str, char c);
  * @param str String to which the other string will be added
  * @param cstr C-String
  */
-void str_add_cstr(str_t* str, char* cstr);
+void str_add_cstr(str_t* str, const char* cstr);
+
+/**
+ * @brief Add first n characters of c-string to existing string
+ *
+ * @param str String to which the characters will be added
+ * @param cstr Characters (don't have to be null terminated)
+ * @param n Number of characters
+ */
+void str_add_cstr_n(str_t* str, const char* cstr, size_t n);
 
 /**
  * @brief Add string to existing string
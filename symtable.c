@@ -14,72 +14,91 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "error.h"
+#include "intern.h"
 #include "token.h"
 
-#define AVG_LEN_MAX 2.0
-#define INIT_SIZE 8
+// Table grows when more than half of slots are used
+#define LOAD_MAX_NUM 1
+#define LOAD_MAX_DEN 2
+#define INIT_SIZE 32
 
-size_t htab_hash_function(const char* str) {
-    uint32_t h = 0;  // musí mít 32 bitů
-    const unsigned char* p;
-    for (p = (const unsigned char*)str; *p != '\0'; p++)
-        h = 65599 * h + *p;
+/**
+ * @brief Mix bits of the key hash, so its low bits can be used as slot index
+ *
+ * Hash of interned strings has poor low bits for names differing only in last characters (e.g.
+ * $var1, $var2, ...), which makes long clusters with linear probing.
+ *
+ * @param key Interned key
+ * @return Hash stored in the slot
+ */
+static inline uint32_t htab_hash(htab_key_t key) {
+    uint32_t h = intern_hash(key);
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
     return h;
 }
 
+/**
+ * @brief Check if slot is empty (never filled or filled before the last htab_clear)
+ *
+ * @param t Hash table
+ * @param slot Slot
+ * @return true if slot is empty
+ */
+static inline bool htab_slot_empty(const htab_t* t, const struct htab_slot* slot) {
+    return slot->generation != t->generation;
+}
+
+/**
+ * @brief Place slot into the first empty slot after its home (linear probing)
+ *
+ * @param t Hash table
+ * @param slot Slot to be placed
+ */
+static void htab_place(htab_t* t, struct htab_slot slot) {
+    size_t mask = t->arr_size - 1;
+    size_t index = slot.hash & mask;
+
+    while (!htab_slot_empty(t, &t->arr_ptr[index])) {
+        struct htab_slot* other = &t->arr_ptr[index];
+        // This shouldn't happen
+        if (other->hash == slot.hash && other->pair->key == slot.pair->key) {
+            fprintf(stderr, "Error: Key already exists in the table\n");
+            error_exit(ERR_INTERNAL);
+        }
+        index = (index + 1) & mask;
+    }
+    t->arr_ptr[index] = slot;
+}
+
 void htab_resize(htab_t* t, size_t newn) {
     if (t == NULL) {
         return;
     }
 
-    // Allocate new array
-    struct htab_item** new_arr = malloc(newn * sizeof(struct htab_item*));
+    // Allocate new array (all slots empty)
+    struct htab_slot* new_arr = calloc(newn, sizeof(struct htab_slot));
     if (new_arr == NULL) {
         error_exit(ERR_INTERNAL);
     }
 
-    // Initialize new array
-    for (size_t i = 0; i < newn; i++) {
-        new_arr[i] = NULL;
-    }
-
-    // Rehash old items into new array
-    for (size_t i = 0; i < t->arr_size; i++) {
-        struct htab_item* item = t->arr_ptr[i];
-        while (item != NULL) {
-            // Get reference to next item
-            struct htab_item* next = item->next;
-
-            // Reset item's next pointer
-            item->next = NULL;
-
-            // Find new bucket
-            size_t index = htab_hash_function(item->pair.key) % newn;
-
-            struct htab_item* current = new_arr[index];
-
-            // Add to head
-            if (current == NULL) {
-                new_arr[index] = item;
-            } else {
-                // Add to tail
-                while (current->next != NULL) {
-                    current = current->next;
-                }
-                current->next = item;
-            }
+    struct htab_slot* old_arr = t->arr_ptr;
+    size_t old_size = t->arr_size;
+    t->arr_ptr = new_arr;
+    t->arr_size = newn;
 
-            // Update pointer to next item
-            item = next;
+    // Reinsert old slots (stored hash is used, keys are not touched)
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_arr[i].generation == t->generation) {
+            htab_place(t, old_arr[i]);
         }
     }
 
     // Free old array
-    free(t->arr_ptr);
-
-    // Update array pointer and size inside table
-    t->arr_ptr = new_arr;
-    t->arr_size = newn;
+    free(old_arr);
 }
 
 size_t htab_bucket_count(const htab_t* t) {
@@ -95,54 +114,55 @@ void htab_clear(htab_t* t) {
         return;
     }
 
-    // Iterate over all buckets
-    for (size_t i = 0; i < t->arr_size; i++) {
-        struct htab_item* item = t->arr_ptr[i];
-        // Item exists
-        while (item != NULL) {
-            struct htab_item* next = item->next;
-
-            // Free the item
-            free((char*)item->pair.key);
-            if (item->pair.value.type == HTAB_FUNCTION) {
-                for (int j = 0; j < item->pair.value.function.param_count; j++) {
-                    str_free(&item->pair.value.function.params[j].name);
-                }
-                free(item->pair.value.function.params);
-            }
-            free(item);
-
-            // Update pointer
-            item = next;
-        }
-        // Clear bucket pointer
-        t->arr_ptr[i] = NULL;
+    // Slots of previous generation are empty (pairs are owned by the arena, keys by the intern
+    // pool), so locals of a function are dropped without touching the array
+    t->generation++;
+    if (t->generation == 0) {
+        // Generation wrapped around, old slots could look used again
+        memset(t->arr_ptr, 0, t->arr_size * sizeof(struct htab_slot));
+        t->generation = 1;
     }
     // Clear size
     t->size = 0;
 }
 
-htab_pair_t* htab_find(htab_t* t, htab_key_t key) {
+/**
+ * @brief Find item in hash table by interned key
+ *
+ * @param t Hash table
+ * @param key Interned key of searched item
+ * @return Pointer to item or NULL if not found
+ */
+static htab_pair_t* htab_find_interned(htab_t* t, htab_key_t key) {
     if (t == NULL || key == NULL) {
         return NULL;
     }
 
-    // Find item bucket
-    size_t index = htab_hash_function(key) % t->arr_size;
-    struct htab_item* item = t->arr_ptr[index];
+    // Find home slot (hash of the key was computed when key was interned)
+    uint32_t hash = htab_hash(key);
+    size_t mask = t->arr_size - 1;
+    size_t index = hash & mask;
 
-    // Find item
-    while (item != NULL) {
-        // Found the item
-        if (strcmp(item->pair.key, key) == 0) {
-            return &(item->pair);
+    while (true) {
+        struct htab_slot* slot = &t->arr_ptr[index];
+        // Empty slot ends the probe sequence (items are never removed one by one)
+        if (htab_slot_empty(t, slot)) {
+            return NULL;
+        }
+        // Found the item (pair is touched only when hash matches, interned keys are equal only if
+        // they are the same pointer)
+        if (slot->hash == hash && slot->pair->key == key) {
+            return slot->pair;
         }
-        // Update pointer
-        item = item->next;
+        index = (index + 1) & mask;
     }
+}
 
-    // Item not found
-    return NULL;
+htab_pair_t* htab_find(htab_t* t, htab_key_t key) {
+    if (key == NULL) {
+        return NULL;
+    }
+    return htab_find_interned(t, intern_cstr(key));
 }
 
 void htab_free(htab_t* t) {
@@ -150,9 +170,6 @@ void htab_free(htab_t* t) {
         return;
     }
 
-    // Clear the table
-    htab_clear(t);
-
     // Free the array
     free(t->arr_ptr);
 
@@ -160,90 +177,73 @@ void htab_free(htab_t* t) {
     free(t);
 }
 
-htab_t* htab_new() {
+htab_t* htab_new(arena_t* arena) {
     // Allocate memory for the table
     htab_t* t = malloc(sizeof(htab_t));
     if (t == NULL) {
         error_exit(ERR_INTERNAL);
     }
 
-    // Allocate memory for the array
-    t->arr_ptr = malloc(INIT_SIZE * sizeof(struct htab_item*));
+    // Allocate memory for the array (all slots empty)
+    t->arr_ptr = calloc(INIT_SIZE, sizeof(struct htab_slot));
     if (t->arr_ptr == NULL) {
         free(t);
         error_exit(ERR_INTERNAL);
     }
 
     // Initialize everything
-    for (size_t i = 0; i < INIT_SIZE; i++) {
-        t->arr_ptr[i] = NULL;
-    }
     t->arr_size = INIT_SIZE;
     t->size = 0;
+    t->generation = 1;
+    t->arena = arena;
 
     return t;
 }
 
-htab_pair_t* htab_add(htab_t* t, htab_key_t key, htab_value_t value) {
+/**
+ * @brief Add new item to hash table
+ *
+ * @param t Hash table
+ * @param key Interned key (e.g. variable name)
+ * @param value Value (e.g. variable type)
+ * @return htab_pair_t*
+ */
+static htab_pair_t* htab_add_interned(htab_t* t, htab_key_t key, htab_value_t value) {
     if (t == NULL || key == NULL) {
         return NULL;
     }
 
-    // Look if pair already exists
-    htab_pair_t* pair = htab_find(t, key);
-
-    // This shouldn't happen
-    if (pair != NULL) {
-        fprintf(stderr, "Error: Key already exists in the table\n");
-        error_exit(ERR_INTERNAL);
-    }
-
-    // Create new item
-    struct htab_item* item = malloc(sizeof(struct htab_item));
-    if (item == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
-
-    // Initialize item
-    item->next = NULL;
-    item->pair.key = malloc(strlen(key) + 1);
-    if (item->pair.key == NULL) {
-        free(item);
-        error_exit(ERR_INTERNAL);
+    // Grow before the table gets too full
+    if ((t->size + 1) * LOAD_MAX_DEN > htab_bucket_count(t) * LOAD_MAX_NUM) {
+        htab_resize(t, htab_bucket_count(t) * 2);
     }
-    strcpy((char*)item->pair.key, key);
-    item->pair.value = value;
 
-    // Add to list
-    size_t index = htab_hash_function(key) % t->arr_size;
-    struct htab_item* target = t->arr_ptr[index];
+    // Create new pair
+    htab_pair_t* pair = arena_alloc(t->arena, sizeof(htab_pair_t));
+    pair->key = key;
+    pair->value = value;
 
-    // Add to head
-    if (target == NULL) {
-        t->arr_ptr[index] = item;
-    } else {
-        // Add to tail
-        while (target->next != NULL) {
-            target = target->next;
-        }
-        target->next = item;
-    }
+    // Add to array (fails if pair already exists)
+    struct htab_slot slot = {.hash = htab_hash(key), .generation = t->generation, .pair = pair};
+    htab_place(t, slot);
 
     // Update size
     t->size++;
 
-    // Update hash table size
-    if (htab_size(t) / (double)htab_bucket_count(t) > AVG_LEN_MAX) {
-        htab_resize(t, htab_bucket_count(t) * 2);
-    }
-
     // Return new item
-    return &(item->pair);
+    return pair;
+}
+
+htab_pair_t* htab_add(htab_t* t, htab_key_t key, htab_value_t value) {
+    if (key == NULL) {
+        return NULL;
+    }
+    return htab_add_interned(t, intern_cstr(key), value);
 }
 
 htab_pair_t* htab_add_function(htab_t* t, token_t* token, bool definition) {
     // Check if function is already defined
-    htab_pair_t* pair = htab_find(t, token->attr.val_s.val);
+    htab_pair_t* pair = htab_find_interned(t, token->attr.val_s);
     // When we are defining new function and it already exists
     if (definition && pair != NULL && pair->value.function.defined) {
         error_exit(ERR_SEM_FUN);
@@ -258,26 +258,30 @@ htab_pair_t* htab_add_function(htab_t* t, token_t* token, bool definition) {
     }
 
     // Add function to symbol table
-    return htab_add(
-        t, token->attr.val_s.val,
+    return htab_add_interned(
+        t, token->attr.val_s,
         (htab_value_t){
             .type = HTAB_FUNCTION,
             .function = {.param_count = 0, .param_count_guess = -1, .defined = definition}});
 }
 
-void htab_function_add_param(htab_pair_t* fun, token_t* token) {
-    // Increase parameter count
-    fun->value.function.param_count++;
+void htab_function_add_param(htab_t* t, htab_pair_t* fun, token_t* token) {
+    int count = fun->value.function.param_count;
 
-    // Resize parameter array
-    htab_param_t* params =
-        realloc(fun->value.function.params, fun->value.function.param_count * sizeof(htab_param_t));
-    if (params == NULL) {
-        error_exit(ERR_INTERNAL);
+    // Grow parameter array when count reaches power of two (old array stays in the arena)
+    if ((count & (count - 1)) == 0) {
+        size_t size = (count ? count * 2 : 1) * sizeof(htab_param_t);
+        htab_param_t* params = arena_alloc(t->arena, size);
+        if (count > 0) {
+            memcpy(params, fun->value.function.params, count * sizeof(htab_param_t));
+        }
+        fun->value.function.params = params;
     }
 
+    // Increase parameter count
+    fun->value.function.param_count++;
+
     // Copy attributes from token
-    fun->value.function.params = params;
     fun->value.function.params[fun->value.function.param_count - 1].type = token->type;
     fun->value.function.params[fun->value.function.param_count - 1].required = !token->attr.val_b;
 }
@@ -285,14 +289,14 @@ void htab_function_add_param(htab_pair_t* fun, token_t* token) {
 void htab_function_add_param_name(htab_pair_t* fun, token_t* token) {
     // Check if we are not redefining parameter
     for (int i = 0; i < fun->value.function.param_count - 1; i++) {
-        if (strcmp(fun->value.function.params[i].name.val, token->attr.val_s.val) == 0) {
+        if (str_val(&fun->value.function.params[i].name) == token->attr.val_s) {
             error_exit(ERR_SEM_CALL);
         }
     }
 
-    // Copy parameter name
+    // Parameter name is interned, so it is enough to keep the view
     fun->value.function.params[fun->value.function.param_count - 1].name =
-        str_new_from_str(&token->attr.val_s);
+        str_new_view(token->attr.val_s, intern_len(token->attr.val_s));
 }
 
 void htab_function_add_return_type(htab_pair_t* fun, token_t* token) {
@@ -303,16 +307,13 @@ void htab_function_add_return_type(htab_pair_t* fun, token_t* token) {
 
 void htab_function_check_all_defined(htab_t* t) {
     for (size_t i = 0; i < t->arr_size; i++) {
-        struct htab_item* item = t->arr_ptr[i];
-        // Item exists
-        while (item != NULL) {
-            if (item->pair.value.type == HTAB_FUNCTION) {
-                // Check if function is defined
-                if (!item->pair.value.function.defined) {
-                    error_exit(ERR_SEM_FUN);
-                }
+        htab_pair_t* pair = t->arr_ptr[i].pair;
+        // Slot is used
+        if (!htab_slot_empty(t, &t->arr_ptr[i]) && pair->value.type == HTAB_FUNCTION) {
+            // Check if function is defined
+            if (!pair->value.function.defined) {
+                error_exit(ERR_SEM_FUN);
             }
-            item = item->next;
         }
     }
 }
@@ -348,15 +349,15 @@ void htab_function_check_params(htab_pair_t* fun, int param_count, bool definiti
 
 bool htab_add_variable(htab_t* t, token_t* token) {
     // Check if variable is already defined
-    if (htab_find(t, token->attr.val_s.val) != NULL) {
+    if (htab_find_interned(t, token->attr.val_s) != NULL) {
         // We can redefine variables
         return false;
     }
     // Add variable to symbol table
-    htab_add(t, token->attr.val_s.val,
-             (htab_value_t){
-                 .type = HTAB_VARIABLE,
-             });
+    htab_add_interned(t, token->attr.val_s,
+                      (htab_value_t){
+                          .type = HTAB_VARIABLE,
+                      });
     return true;
 }
 
@@ -405,10 +406,7 @@ void htab_define_buildin(htab_t* t) {
              });
 
     // strlen
-    params = malloc(sizeof(htab_param_t));
-    if (params == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].type = TOK_STRING;
     params[0].name = str_new();
     params[0].required = true;
@@ -422,10 +420,7 @@ void htab_define_buildin(htab_t* t) {
              });
 
     // chr
-    params = malloc(sizeof(htab_param_t));
-    if (params == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].type = TOK_INT;
     params[0].name = str_new();
     params[0].required = true;
@@ -439,10 +434,7 @@ void htab_define_buildin(htab_t* t) {
              });
 
     // ord
-    params = malloc(sizeof(htab_param_t));
-    if (params == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].type = TOK_STRING;
     params[0].name = str_new();
     params[0].required = true;
@@ -456,10 +448,7 @@ void htab_define_buildin(htab_t* t) {
              });
 
     // substring
-    params = malloc(3 * sizeof(htab_param_t));
-    if (params == NULL) {
-        error_exit(ERR_INTERNAL);
-    }
+    params = arena_alloc(t->arena, 3 * sizeof(htab_param_t));
     params[0].type = TOK_STRING;
     params[0].name = str_new();
     params[0].required = true;
@@ -475,10 +464,10 @@ void htab_define_buildin(htab_t* t) {
                  .function = {.param_count = 3,
                               .defined = true,
                               .params = params,
-                              .returns = {.type = TOK_STRING, .required = true}},
+                              .returns = {.type = TOK_STRING, .required = false}},
              });
     // floatval
-    params = malloc(sizeof(htab_param_t));
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].required = true;
     params[0].name = str_new();
     htab_add(t, "floatval",
@@ -491,7 +480,7 @@ void htab_define_buildin(htab_t* t) {
              });
 
     // intval
-    params = malloc(sizeof(htab_param_t));
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].required = true;
     params[0].name = str_new();
     htab_add(t, "intval",
@@ -503,7 +492,7 @@ void htab_define_buildin(htab_t* t) {
                               .returns = {.type = TOK_INT, .required = true}},
              });
     // strval
-    params = malloc(sizeof(htab_param_t));
+    params = arena_alloc(t->arena, sizeof(htab_param_t));
     params[0].required = true;
     params[0].name = str_new();
     htab_add(t, "strval",
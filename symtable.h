@@ -13,7 +13,9 @@
 #define __SYMTABLE_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include "arena.h"
 #include "str.h"
 #include "token.h"
 
@@ -45,7 +47,7 @@ typedef struct {
     htab_return_t returns;
 } htab_fun_t;
 
-typedef const char* htab_key_t;  // Key type
+typedef const char* htab_key_t;  // Key type (interned string, compared by pointer)
 typedef struct {
     htab_value_type_t type;
     union {
@@ -60,25 +62,29 @@ typedef struct htab_pair {
     htab_value_t value;  // Value
 } htab_pair_t;
 
-// One item in hash table
-struct htab_item {
-    struct htab_pair pair;
-    struct htab_item* next;
+// One slot of the open addressing array (used only if its generation is the table's one)
+struct htab_slot {
+    uint32_t hash;        // Hash of the key (compared before the pair is touched)
+    uint32_t generation;  // Generation of the table when the slot was filled
+    htab_pair_t* pair;    // Pair (allocated from arena, so pointers stay valid after resize)
 };
 
-// Hash table representation
+// Hash table representation (open addressing with linear probing, at most half full)
 struct htab {
     size_t size;
-    size_t arr_size;
-    struct htab_item** arr_ptr;
+    size_t arr_size;  // Number of slots (power of two)
+    struct htab_slot* arr_ptr;
+    uint32_t generation;  // Current generation (incremented by htab_clear, never 0)
+    arena_t* arena;       // Pairs and parameter arrays are allocated from it
 };
 
 /**
  * @brief Create new hash table
  *
+ * @param arena Arena for items (has to live as long as they are used)
  * @return htab_t*
  */
-htab_t* htab_new();
+htab_t* htab_new(arena_t* arena);
 
 /**
  * @brief Get number of items in hash table
@@ -92,7 +98,7 @@ size_t htab_size(const htab_t* t);
  * @brief Find item in hash table
  *
  * @param t Hash table
- * @param key  Key of searched item
+ * @param key  Key of searched item (interned automatically)
  * @return Pointer to item or NULL if not found
  */
 htab_pair_t* htab_find(htab_t* t, htab_key_t key);
@@ -101,7 +107,7 @@ htab_pair_t* htab_find(htab_t* t, htab_key_t key);
  * @brief Add new item to hash table
  *
  * @param t Hash table
- * @param key Key (e.g. variable name)
+ * @param key Key (e.g. variable name, interned automatically)
  * @param value Value (e.g. variable type)
  * @return htab_pair_t*
  */
@@ -119,10 +125,11 @@ htab_pair_t* htab_add_function(htab_t* t, token_t* token, bool definition);
 /**
  * @brief Add parameter to existing function
  *
+ * @param t Hash table containing the function
  * @param fun Pointer to function inside hash table
  * @param token Current token (type)
  */
-void htab_function_add_param(htab_pair_t* fun, token_t* token);
+void htab_function_add_param(htab_t* t, htab_pair_t* fun, token_t* token);
 
 /**
  * @brief Add parameter name to existing function parameter
@@ -167,14 +174,15 @@ void htab_function_check_all_defined(htab_t* t);
 void htab_function_check_params(htab_pair_t* fun, int param_count, bool definition);
 
 /**
- * @brief Remove all items from hash table
+ * @brief Remove all items from hash table in O(1) (their memory is released by resetting the
+ * arena)
  *
  * @param t Hash table
  */
 void htab_clear(htab_t* t);
 
 /**
- * @brief Free hash table
+ * @brief Free hash table (arena is not freed)
  *
  * @param t Hash table
  */
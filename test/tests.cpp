@@ -1,7 +1,24 @@
 extern "C" {
+#include "../arena.h"
+#include "../gen.h"
+#include "../infer.h"
+#include "../ir.h"
+#include "../intern.h"
+#include "../parser.h"
+#include "../postfix.h"
+#include "../rope.h"
 #include "../scanner.h"
+#include "../scanner_parallel.h"
+#include "../skip.h"
+// stack_t of the expression parser clashes with stack_t of signal.h (included by gtest)
+#define stack_t exp_stack_t
+#include "../stack.h"
+#undef stack_t
+#include "../token_queue.h"
 }
 
+#include <random>
+
 #include "gtest/gtest.h"
 
 TEST(LexicalTest, Keywords) {
@@ -81,6 +98,66 @@ TEST(LexicalTest, Numbers) {
     fclose(input);
 }
 
+TEST(LexicalTest, IntOverflow) {
+    const char source[] = "<?php\n9223372036854775807 9223372036854775808 000000000000000000000042";
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+
+    // Integer literal too big for int becomes float (same as in PHP)
+    auto token = scanner_get_next(&scanner);
+    EXPECT_EQ(token.type, TOK_INT_LIT);
+    EXPECT_EQ(token.attr.val_i, INT64_MAX);
+
+    token = scanner_get_next(&scanner);
+    EXPECT_EQ(token.type, TOK_FLOAT_LIT);
+    EXPECT_EQ(token.attr.val_f, 9223372036854775808.0);
+
+    token = scanner_get_next(&scanner);
+    EXPECT_EQ(token.type, TOK_INT_LIT);
+    EXPECT_EQ(token.attr.val_i, 42);
+
+    scanner_free(&scanner);
+}
+
+TEST(LexicalTest, FloatsSameAsStrtod) {
+    // Random literals with short and long mantissas, leading zeros and extreme exponents
+    std::mt19937_64 random(2022);
+    std::vector<std::string> literals = {"2.2250738585072011e-308", "4.9406564584124654e-324",
+                                         "2.4703282292062328e-324", "1.7976931348623158e308",
+                                         "1e309", "1e-400", "9007199254740993.0",
+                                         "0.1000000000000000055511151231257827021181583404541015625"};
+    for (int i = 0; i < 100000; i++) {
+        std::string literal;
+        int digits = 1 + random() % (random() % 4 == 0 ? 40 : 20);
+        for (int j = 0; j < digits; j++) {
+            literal += (char)('0' + random() % 10);
+        }
+        if (random() % 2) {
+            literal += '.';
+            int fraction = 1 + random() % 30;
+            for (int j = 0; j < fraction; j++) {
+                literal += (char)('0' + random() % 10);
+            }
+        }
+        literal += "eE"[random() % 2];
+        literal += std::string("+-")[random() % 2];
+        literal += std::to_string(random() % 3 == 0 ? random() % 400 : random() % 40);
+        literals.push_back(literal);
+    }
+
+    std::string source = "<?php\n";
+    for (auto& literal : literals) {
+        source += literal + " ";
+    }
+    auto scanner = scanner_new_from_buffer(source.c_str(), source.size());
+    for (auto& literal : literals) {
+        auto token = scanner_get_next(&scanner);
+        ASSERT_EQ(token.type, TOK_FLOAT_LIT) << literal;
+        double expected = strtod(literal.c_str(), NULL);
+        EXPECT_EQ(memcmp(&token.attr.val_f, &expected, sizeof(double)), 0) << literal;
+    }
+    scanner_free(&scanner);
+}
+
 TEST(LexicalTest, Operators){
     auto input = tmpfile();
     fprintf(input, "<?php\n+ - * / < <= > >= === !==");
@@ -168,14 +245,14 @@ TEST(LexicalTest, VariableAndFunction) {
 
     auto token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_VAR);
-    EXPECT_STREQ(token.attr.val_s.val, "$a");
+    EXPECT_EQ(std::string(token.attr.val_s, intern_len(token.attr.val_s)), "$a");
 
     token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_ASSIGN);
 
     token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_FUN_NAME);
-    EXPECT_STREQ(token.attr.val_s.val, "readi");
+    EXPECT_EQ(std::string(token.attr.val_s, intern_len(token.attr.val_s)), "readi");
 
     token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_LPAREN);
@@ -201,7 +278,7 @@ TEST(LexicalTest, StringAndComment) {
 
     auto token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_STR_LIT);
-    EXPECT_STREQ(token.attr.val_s.val, "Hello World");
+    EXPECT_EQ(std::string(token.attr.val_s, intern_len(token.attr.val_s)), "Hello World");
 
     token = scanner_get_next(&scanner);
     EXPECT_EQ(token.type, TOK_EOF);
@@ -209,6 +286,33 @@ TEST(LexicalTest, StringAndComment) {
     fclose(input);
 }
 
+/**
+ * @brief Lex whole input and exit (death tests check exit code, 1 = ERR_LEX, 2 = ERR_SYN)
+ */
+static void lex_all(const char* source) {
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    while (scanner_get_next(&scanner).type != TOK_EOF) {
+    }
+    scanner_free(&scanner);
+    exit(0);
+}
+
+TEST(LexicalTest, Errors) {
+    EXPECT_EXIT(lex_all("<?php\n$a = 1;\n?>\n"), testing::ExitedWithCode(0), "");
+    EXPECT_EXIT(lex_all("<?php\n$a = 1;\n?>\r\n"), testing::ExitedWithCode(0), "");
+    EXPECT_EXIT(lex_all("<?pHp\n"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n$1"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n1.e5"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n1e+x"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n12ab"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n$a ! $b"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n\"tab\tinside\""), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n/* unterminated"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n#"), testing::ExitedWithCode(1), "");
+    EXPECT_EXIT(lex_all("<?php\n?>\n$a"), testing::ExitedWithCode(2), "");
+    EXPECT_EXIT(lex_all("<?php\n?> "), testing::ExitedWithCode(2), "");
+}
+
 // TEST(LexicalTest, Bonus){
 //     auto input = tmpfile();
 //     fprintf(input, "<?php\ntrue false");
@@ -223,3 +327,680 @@ TEST(LexicalTest, StringAndComment) {
 //     EXPECT_EQ(token.type, TOK_FALSE);
 //     fclose(input);
 // }
+
+TEST(KeywordTest, AllKeywords) {
+    const struct {
+        const char* name;
+        token_type_t type;
+    } keywords[] = {{"else", TOK_ELSE},     {"float", TOK_FLOAT},   {"function", TOK_FUNCTION},
+                    {"if", TOK_IF},         {"int", TOK_INT},       {"null", TOK_NULL},
+                    {"return", TOK_RETURN}, {"string", TOK_STRING}, {"void", TOK_VOID},
+                    {"while", TOK_WHILE},   {"for", TOK_FOR},       {"break", TOK_BREAK},
+                    {"continue", TOK_CONTINUE}};
+
+    for (auto& keyword : keywords) {
+        auto str = str_new();
+        str_add_cstr(&str, (char*)keyword.name);
+        EXPECT_EQ(get_keyword_token_type(&str), keyword.type) << keyword.name;
+        str_free(&str);
+    }
+}
+
+TEST(KeywordTest, NotKeywords) {
+    const char* identifiers[] = {"",      "i",     "iff",        "If",      "elsee", "whilst",
+                                 "fo",    "nul",   "functions",  "strings", "vid",   "wh1le",
+                                 "_else", "float_", "continue_", "write",   "readi", "eelse"};
+
+    for (auto identifier : identifiers) {
+        auto str = str_new();
+        str_add_cstr(&str, (char*)identifier);
+        EXPECT_EQ(get_keyword_token_type(&str), -1) << identifier;
+        str_free(&str);
+    }
+}
+
+TEST(StrTest, Append) {
+    auto str = str_new();
+    std::string expected;
+    for (int i = 0; i < 10000; i++) {
+        str_add_cstr(&str, "LABEL !loop_");
+        str_add_int(&str, i);
+        str_add_char(&str, '\n');
+        expected += "LABEL !loop_" + std::to_string(i) + "\n";
+    }
+    str_reserve(&str, 100);
+    EXPECT_GE(str.large.size, str_len(&str) + 101);
+    str_add_cstr_n(&str, "abc", 2);
+    expected += "ab";
+    EXPECT_EQ(std::string(str_val(&str), str_len(&str)), expected);
+    EXPECT_EQ(str_val(&str)[str_len(&str)], '\0');
+    str_free(&str);
+}
+
+TEST(StrTest, SmallStringsAreInline) {
+    EXPECT_EQ(sizeof(str_t), 24u);
+    auto str = str_new();
+    str_add_cstr(&str, "$short_identifier");
+    EXPECT_EQ(str_val(&str), (char*)&str);
+    // Copies of short strings are inline too (and independent)
+    auto copy = str_new_from_str(&str);
+    str_add_cstr(&str, "_1234");
+    EXPECT_EQ(str_len(&str), (size_t)STR_SMALL_MAX);
+    EXPECT_EQ(str_val(&str), (char*)&str);
+    EXPECT_STREQ(str_val(&copy), "$short_identifier");
+    EXPECT_TRUE(str_eq_cstr(&copy, "$short_identifier"));
+
+    // Longer string moves to heap, view keeps pointing to the original characters
+    str_add_char(&str, '5');
+    EXPECT_NE(str_val(&str), (char*)&str);
+    EXPECT_STREQ(str_val(&str), "$short_identifier_12345");
+    const char text[] = "viewed text";
+    auto view = str_new_view(text, 6);
+    EXPECT_EQ(str_val(&view), text);
+    EXPECT_EQ(str_len(&view), 6u);
+    str_clear(&str);
+    EXPECT_EQ(str_len(&str), 0u);
+    EXPECT_STREQ(str_val(&str), "");
+
+    str_free(&str);
+    str_free(&copy);
+    str_free(&view);
+}
+
+TEST(ArenaTest, AllocAndReset) {
+    arena_t* arena = arena_new();
+    char* first = (char*)arena_alloc(arena, 3);
+    char* second = (char*)arena_alloc(arena, 8);
+    EXPECT_EQ((uintptr_t)second % alignof(max_align_t), 0u);
+    EXPECT_GE(second, first + 3);
+
+    // Reset releases everything, the block is reused
+    arena_reset(arena);
+    EXPECT_EQ(arena->used, 0u);
+    EXPECT_EQ((char*)arena_alloc(arena, 3), first);
+
+    // Allocations spanning more blocks (and one bigger than a block) keep their content
+    std::vector<int*> arrays;
+    for (int i = 0; i < 100; i++) {
+        int count = i == 50 ? ARENA_BLOCK_SIZE : 100;
+        int* array = (int*)arena_alloc(arena, count * sizeof(int));
+        for (int j = 0; j < count; j++) {
+            array[j] = i;
+        }
+        arrays.push_back(array);
+    }
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(arrays[i][i == 50 ? ARENA_BLOCK_SIZE - 1 : 99], i);
+    }
+    arena_reset(arena);
+    EXPECT_EQ(arena->used, 0u);
+    arena_free(arena);
+}
+
+TEST(PostfixTest, TreeOnlyOnRequest) {
+    arena_t* arena = arena_new();
+    auto postfix = postfix_new(arena);
+    // $a . 1 * 2 . $b
+    postfix_add(&postfix, token_new(TOK_VAR, 0));
+    postfix_add(&postfix, token_new_with_int(TOK_INT_LIT, 1, 0));
+    postfix_add(&postfix, token_new_with_int(TOK_INT_LIT, 2, 0));
+    postfix_add(&postfix, token_new(TOK_MULTIPLY, 0));
+    postfix_add(&postfix, token_new(TOK_DOT, 0));
+    postfix_add(&postfix, token_new(TOK_VAR, 0));
+    postfix_add(&postfix, token_new(TOK_DOT, 0));
+
+    auto root = postfix_to_tree(&postfix);
+    EXPECT_EQ(root->value.type, TOK_DOT);
+    EXPECT_EQ(root->result, TOK_STR_LIT);
+    EXPECT_EQ(root->right->value.type, TOK_VAR);
+    EXPECT_EQ(root->left->value.type, TOK_DOT);
+    EXPECT_EQ(root->left->left->value.type, TOK_VAR);
+    EXPECT_EQ(root->left->right->value.type, TOK_MULTIPLY);
+    EXPECT_EQ(root->left->right->result, TOK_VAR);
+    EXPECT_EQ(root->left->right->right->value.attr.val_i, 2);
+
+    // Long chains don't need recursion
+    arena_reset(arena);
+    postfix = postfix_new(arena);
+    postfix_add(&postfix, token_new(TOK_VAR, 0));
+    for (int i = 0; i < 100000; i++) {
+        postfix_add(&postfix, token_new(TOK_VAR, 0));
+        postfix_add(&postfix, token_new(TOK_DOT, 0));
+    }
+    EXPECT_EQ(postfix.len, 200001);
+    EXPECT_EQ(postfix_to_tree(&postfix)->left->value.type, TOK_DOT);
+    arena_free(arena);
+}
+
+TEST(StackTest, ShiftReduceKeepsTopTerminal) {
+    arena_t* arena = arena_new();
+    exp_stack_t stack = stack_new(arena);
+    // $ ( ( ( ... (more items than the initial capacity)
+    stack_shift(&stack, token_new(TOK_DOLLAR, 0), false);
+    for (int i = 0; i < 20; i++) {
+        stack_shift(&stack, token_new(TOK_LPAREN, i), true);
+    }
+    EXPECT_EQ(stack.len, 21);
+    EXPECT_GE(stack.size, 21);
+    EXPECT_EQ(stack_top_terminal(&stack)->type, TOK_LPAREN);
+    EXPECT_EQ(stack_top_terminal(&stack)->offset, 19u);
+
+    // ( 1 -> ( E
+    stack_shift(&stack, token_new_with_int(TOK_INT_LIT, 1, 0), true);
+    EXPECT_EQ(stack_handle(&stack), 21);
+    stack_reduce(&stack, 21, stack_top(&stack)->token);
+    EXPECT_FALSE(stack_top(&stack)->terminal);
+    EXPECT_EQ(stack_top_terminal(&stack)->type, TOK_LPAREN);
+
+    // ( E + 2 -> ( E + E, handle starts at the first nonterminal
+    stack_shift(&stack, token_new(TOK_PLUS, 0), true);
+    EXPECT_TRUE(stack.items[21].handle);
+    EXPECT_EQ(stack_top_terminal(&stack)->type, TOK_PLUS);
+    stack_shift(&stack, token_new_with_int(TOK_INT_LIT, 2, 0), true);
+    stack_reduce(&stack, stack_handle(&stack), stack_top(&stack)->token);
+    EXPECT_EQ(stack_top_terminal(&stack)->type, TOK_PLUS);
+    EXPECT_EQ(stack.len, 24);
+
+    // ( E + E -> ( E, terminal below the handle is the top one again
+    EXPECT_EQ(stack_handle(&stack), 21);
+    stack_reduce(&stack, 21, token_new(TOK_PLUS, 0));
+    EXPECT_EQ(stack.len, 22);
+    EXPECT_FALSE(stack_top(&stack)->terminal);
+    EXPECT_FALSE(stack_top(&stack)->handle);
+    EXPECT_EQ(stack_top(&stack)->token.type, TOK_PLUS);
+    EXPECT_EQ(stack_top_terminal(&stack)->offset, 19u);
+
+    // ( E ) -> E, handle starts at the parenthesis
+    stack_shift(&stack, token_new(TOK_RPAREN, 0), false);
+    EXPECT_EQ(stack_handle(&stack), 20);
+    stack_reduce(&stack, 20, token_new(TOK_PLUS, 0));
+    EXPECT_EQ(stack.len, 21);
+    EXPECT_EQ(stack_top_terminal(&stack)->type, TOK_LPAREN);
+    EXPECT_EQ(stack_top_terminal(&stack)->offset, 18u);
+    EXPECT_EQ(stack.items[stack.top_terminal].below, 18);
+
+    stack_free(&stack);
+    arena_free(arena);
+}
+
+TEST(SymtableTest, AddFindAndClear) {
+    arena_t* arena = arena_new();
+    htab_t* table = htab_new(arena);
+    std::vector<htab_pair_t*> pairs;
+    for (int i = 0; i < 10000; i++) {
+        auto name = "v" + std::to_string(i);
+        pairs.push_back(htab_add(table, name.c_str(), (htab_value_t){.type = HTAB_VARIABLE}));
+    }
+    EXPECT_EQ(htab_size(table), 10000u);
+
+    // Pairs don't move when the table grows
+    for (int i = 0; i < 10000; i++) {
+        auto name = "v" + std::to_string(i);
+        EXPECT_EQ(htab_find(table, name.c_str()), pairs[i]);
+    }
+    EXPECT_EQ(htab_find(table, "v10000"), nullptr);
+
+    // Adding existing variable only reports it
+    auto token = token_new_with_string(TOK_VAR, "v42", 3, 0);
+    EXPECT_FALSE(htab_add_variable(table, &token));
+    token = token_new_with_string(TOK_VAR, "v10000", 6, 0);
+    EXPECT_TRUE(htab_add_variable(table, &token));
+
+    htab_clear(table);
+    EXPECT_EQ(htab_size(table), 0u);
+    EXPECT_EQ(htab_find(table, "v42"), nullptr);
+
+    // Items of previous generations stay hidden, also when generation wraps around
+    table->generation = UINT32_MAX - 1;
+    for (int round = 0; round < 4; round++) {
+        auto name = "r" + std::to_string(round);
+        EXPECT_NE(htab_add(table, name.c_str(), (htab_value_t){.type = HTAB_VARIABLE}), nullptr);
+        EXPECT_EQ(htab_size(table), 1u);
+        if (round > 0) {
+            EXPECT_EQ(htab_find(table, ("r" + std::to_string(round - 1)).c_str()), nullptr);
+        }
+        htab_clear(table);
+    }
+    htab_free(table);
+    arena_free(arena);
+}
+
+TEST(RopeTest, SpliceAndWrite) {
+    auto rope = rope_new();
+    auto small = rope_new();
+    auto big = rope_new();
+    std::string expected;
+    rope_add_cstr(&rope, "LABEL main\n");
+    expected += "LABEL main\n";
+    for (int i = 0; i < 20000; i++) {
+        rope_add_cstr(&big, "PUSHS int@");
+        rope_add_int(&big, i);
+        rope_add_char(&big, '\n');
+    }
+    rope_add_cstr_n(&small, "RETURN\n!!", 7);
+
+    // Small rope is copied, big one is linked, both end up empty
+    std::string big_text;
+    for (int i = 0; i < 20000; i++) {
+        big_text += "PUSHS int@" + std::to_string(i) + "\n";
+    }
+    expected += "RETURN\n" + big_text + "RETURN\n";
+    rope_splice(&rope, &small);
+    rope_add_cstr(&small, "RETURN\n");
+    rope_splice(&rope, &big);
+    rope_splice(&rope, &small);
+    EXPECT_EQ(small.len, 0u);
+    EXPECT_EQ(big.len, 0u);
+    EXPECT_EQ(big.head, nullptr);
+    EXPECT_EQ(rope.len, expected.size());
+
+    FILE* file = tmpfile();
+    rope_write(&rope, file);
+    rewind(file);
+    std::string written(expected.size() + 1, '\0');
+    written.resize(fread(&written[0], 1, written.size(), file));
+    EXPECT_EQ(written, expected);
+    fclose(file);
+
+    rope_free(&rope);
+    rope_free(&small);
+    rope_free(&big);
+}
+
+TEST(GenTest, StreamingJumpsOverFunctions) {
+    const char source[] =
+        "<?php\ndeclare(strict_types=1);\n$a = 1;\n"
+        "function f(int $x): int { return $x; }\n$b = f($a);\nwrite($b);\n";
+    FILE* file = tmpfile();
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    auto gen = gen_new_streaming(file);
+    auto parser = parser_new(&scanner, &gen);
+    parser_run(&parser);
+    gen_emit(&gen);
+    parser_free(&parser);
+    gen_free(&gen);
+    scanner_free(&scanner);
+
+    std::string code(ftell(file), '\0');
+    rewind(file);
+    ASSERT_EQ(fread(&code[0], 1, code.size(), file), code.size());
+    fclose(file);
+
+    // Header (with global variables) is at the end, function is jumped over in global code
+    EXPECT_EQ(code.rfind(".IFJcode22\nJUMP !?header\n", 0), 0u);
+    auto global = code.find("LABEL !?global\n");
+    auto jump = code.find("JUMP !?global_0\n");
+    auto function = code.find("LABEL f\n");
+    auto label = code.find("LABEL !?global_0\n");
+    auto header = code.find("LABEL !?header\n");
+    EXPECT_LT(global, jump);
+    EXPECT_LT(jump, function);
+    EXPECT_LT(function, label);
+    EXPECT_LT(label, header);
+    EXPECT_NE(code.find("DEFVAR GF@$a\n", header), std::string::npos);
+    EXPECT_EQ(code.substr(code.size() - 14), "JUMP !?global\n");
+}
+
+TEST(GenTest, ArithmeticHasInlinePath) {
+    const char source[] =
+        "<?php\ndeclare(strict_types=1);\n$a = readi();\n$b = $a * 2 + $a;\n$c = $a / 2;\n";
+    FILE* file = tmpfile();
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    auto gen = gen_new_streaming(file);
+    auto parser = parser_new(&scanner, &gen);
+    parser_run(&parser);
+    gen_emit(&gen);
+    parser_free(&parser);
+    gen_free(&gen);
+    scanner_free(&scanner);
+
+    std::string code(ftell(file), '\0');
+    rewind(file);
+    ASSERT_EQ(fread(&code[0], 1, code.size(), file), code.size());
+    fclose(file);
+
+    // Both operations have their own fast path, helper is called only from slow path
+    auto mul = code.find("MUL GF@?tmp1 GF@?tmp1 GF@?tmp2\n");
+    auto add = code.find("ADD GF@?tmp1 GF@?tmp1 GF@?tmp2\n");
+    ASSERT_NE(mul, std::string::npos);
+    ASSERT_NE(add, std::string::npos);
+    EXPECT_LT(mul, add);
+    EXPECT_NE(code.find("LABEL !arith_fast_0\n"), std::string::npos);
+    EXPECT_NE(code.find("LABEL !arith_end_1\n"), std::string::npos);
+    EXPECT_NE(code.find("LABEL !arith_slow_1\nCALL !arith_add\nJUMP !arith_end_1\n"),
+              std::string::npos);
+    EXPECT_NE(code.find("LABEL !arith_mul\nPUSHS GF@?tmp1\nPUSHS GF@?tmp2\nCALL !num_prepare\n"),
+              std::string::npos);
+    // Division always converts to float in the helper
+    EXPECT_NE(code.find("CALL !num_prepare_div\nDIVS\n"), std::string::npos);
+    // Helpers don't create frames
+    EXPECT_NE(code.find("LABEL !num_prepare\nPOPS GF@?tmp2\n"), std::string::npos);
+    EXPECT_EQ(code.find("CALL !comp_prepare\n"), std::string::npos);
+}
+
+TEST(InferTest, JoinsForgetAssignments) {
+    auto infer = infer_new();
+    const char* a = intern_cstr("a");
+    const char* b = intern_cstr("b");
+    EXPECT_EQ(infer_var(&infer, a), INFER_UNKNOWN);
+    infer_assign(&infer, a, INFER_INT);
+    infer_assign(&infer, b, INFER_STRING | INFER_NIL);
+    EXPECT_EQ(infer_var(&infer, a), INFER_INT);
+    EXPECT_EQ(infer_binary(TOK_PLUS, INFER_INT, INFER_INT | INFER_NIL), INFER_INT);
+    EXPECT_EQ(infer_binary(TOK_MINUS, INFER_INT, INFER_FLOAT), INFER_FLOAT);
+    EXPECT_EQ(infer_binary(TOK_DIVIDE, INFER_INT, INFER_INT), INFER_FLOAT);
+    EXPECT_EQ(infer_binary(TOK_MULTIPLY, INFER_STRING, INFER_INT), 0);
+    EXPECT_EQ(infer_binary(TOK_LESS, INFER_STRING, INFER_INT), INFER_BOOL);
+
+    // Branches see types from before the if, only variables assigned inside are forgotten
+    infer_if(&infer);
+    infer_assign(&infer, a, INFER_FLOAT);
+    EXPECT_EQ(infer_var(&infer, a), INFER_FLOAT);
+    infer_if_join(&infer, false);
+    EXPECT_EQ(infer_var(&infer, a), INFER_UNKNOWN);
+    infer_if_join(&infer, true);
+    EXPECT_EQ(infer_var(&infer, a), INFER_UNKNOWN);
+    EXPECT_EQ(infer_var(&infer, b), INFER_STRING | INFER_NIL);
+    infer_assign(&infer, a, INFER_INT);
+    EXPECT_EQ(infer_var(&infer, a), INFER_INT);
+
+    infer_forget(&infer);
+    EXPECT_EQ(infer_var(&infer, a), INFER_UNKNOWN);
+    EXPECT_EQ(infer_var(&infer, b), INFER_UNKNOWN);
+    infer_free(&infer);
+}
+
+TEST(GenTest, InferredTypesDropChecks) {
+    const char source[] =
+        "<?php\ndeclare(strict_types=1);\n$a = 1;\n$b = $a + 2;\nif ($b < 5) {\n$a = readi();\n"
+        "} else {\n}\n$c = $a + $b;\nfunction f(float $x): float { return $x * $x; }\n";
+    FILE* file = tmpfile();
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    auto gen = gen_new_streaming(file);
+    auto parser = parser_new(&scanner, &gen);
+    parser_run(&parser);
+    gen_emit(&gen);
+    parser_free(&parser);
+    gen_free(&gen);
+    scanner_free(&scanner);
+
+    std::string code(ftell(file), '\0');
+    rewind(file);
+    ASSERT_EQ(fread(&code[0], 1, code.size(), file), code.size());
+    fclose(file);
+
+    // $a is int, $b = $a + 2 is int, comparison is bool
+    EXPECT_NE(code.find("PUSHS GF@$a\nPUSHS int@2\nADDS\nPOPS GF@$b\n"), std::string::npos);
+    EXPECT_NE(code.find("CALL !greater\nPOPS GF@?tmp1\nJUMPIFEQ !else_"),
+              std::string::npos);
+    // $a was assigned in the if branch, so it is checked after the if-else
+    EXPECT_NE(code.find("TYPE GF@?type1 GF@$a\nJUMPIFEQ !ERR_SEM_VAR string@ GF@?type1\n"),
+              std::string::npos);
+    EXPECT_NE(code.find("LABEL !arith_slow_0\n"), std::string::npos);
+    // Typed parameter
+    EXPECT_NE(code.find("PUSHS LF@$x\nPUSHS LF@$x\nMULS\n"), std::string::npos);
+}
+
+TEST(IrTest, AsmAndBuiltCodeArePrintedSame) {
+    const char text[] =
+        ".IFJcode22\n"
+        "DEFVAR GF@?tmp1\n"
+        "READ LF@tmp float\n"
+        "MOVE TF@x string@a\\032b\\035\\092\n"
+        "JUMPIFEQ !loop_3 int@-42 float@0x1.8p+1\n"
+        "PUSHS bool@true\n"
+        "PUSHS nil@nil\n"
+        "CALL !concat\n"
+        "RETURN\n";
+    auto parsed = ir_code_new();
+    ir_add_asm(&parsed, text);
+    EXPECT_EQ(parsed.len, 9u);
+    EXPECT_EQ(parsed.items[3].args[1].kind, IR_STRING);
+    EXPECT_EQ(parsed.items[3].args[1].id, 5);
+
+    // Same code built from operands (strings are escaped when printed)
+    auto built = ir_code_new();
+    ir_add(&built, IR_HEADER);
+    ir_add1(&built, IR_DEFVAR, ir_var(IR_GF, "?tmp1"));
+    ir_add2(&built, IR_READ, ir_var(IR_LF, "tmp"), ir_type("float"));
+    ir_add2(&built, IR_MOVE, ir_var(IR_TF, "x"), ir_string("a b#\\", 5));
+    ir_add3(&built, IR_JUMPIFEQ, ir_label("!loop_", 3), ir_int(-42), ir_float(3.0));
+    ir_add1(&built, IR_PUSHS, ir_bool(true));
+    ir_add1(&built, IR_PUSHS, ir_nil());
+    ir_add1(&built, IR_CALL, ir_label("!concat", -1));
+    ir_add(&built, IR_RETURN);
+
+    // Splicing into empty code only swaps vectors
+    auto code = ir_code_new();
+    ir_code_splice(&code, &parsed);
+    ir_code_splice(&code, &built);
+    EXPECT_EQ(parsed.len, 0u);
+    EXPECT_EQ(built.len, 0u);
+
+    FILE* file = tmpfile();
+    ir_code_write(&code, file);
+    std::string written(ftell(file), '\0');
+    rewind(file);
+    ASSERT_EQ(fread(&written[0], 1, written.size(), file), written.size());
+    fclose(file);
+    EXPECT_EQ(written, std::string(text) + text);
+
+    ir_code_free(&code);
+    ir_code_free(&parsed);
+    ir_code_free(&built);
+}
+
+TEST(InternTest, SamePointerForSameText) {
+    const char source[] = "$abc $abcd $abc";
+    const char* a = intern(source, 4);
+    const char* b = intern(source + 5, 5);
+    const char* c = intern(source + 11, 4);
+
+    EXPECT_EQ(a, c);
+    EXPECT_NE(a, b);
+    EXPECT_STREQ(a, "$abc");
+    EXPECT_STREQ(b, "$abcd");
+    EXPECT_EQ(intern_len(b), 5u);
+    EXPECT_EQ(intern_id(a), intern_id(c));
+    EXPECT_NE(intern_id(a), intern_id(b));
+    EXPECT_EQ(intern_cstr("$abc"), a);
+}
+
+TEST(InternTest, ScannerInternsIdentifiers) {
+    const char source[] = "<?php\n$x = foo($x);";
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+
+    auto first = scanner_get_next(&scanner);
+    scanner_get_next(&scanner);
+    auto fun = scanner_get_next(&scanner);
+    scanner_get_next(&scanner);
+    auto second = scanner_get_next(&scanner);
+
+    EXPECT_EQ(first.type, TOK_VAR);
+    EXPECT_EQ(second.type, TOK_VAR);
+    EXPECT_EQ(first.attr.val_s, second.attr.val_s);
+    // Hash computed by the scanner is the same as the one computed by the pool
+    EXPECT_EQ(first.attr.val_s, intern_cstr("$x"));
+    EXPECT_EQ(fun.attr.val_s, intern_cstr("foo"));
+    scanner_free(&scanner);
+}
+
+TEST(TokenQueueTest, PeekAndAdvance) {
+    // More tokens than fits into the ring
+    std::string source = "<?php\n";
+    for (int i = 0; i < 100; i++) {
+        source += "$a + ";
+    }
+    auto scanner = scanner_new_from_buffer(source.c_str(), source.size());
+    auto queue = token_queue_new(&scanner);
+
+    EXPECT_EQ(token_queue_peek(&queue, 0)->type, TOK_VAR);
+    EXPECT_EQ(token_queue_peek(&queue, 1)->type, TOK_PLUS);
+    EXPECT_EQ(token_queue_peek(&queue, TOKEN_QUEUE_SIZE - 1)->type, TOK_PLUS);
+    for (int i = 0; i < 200; i++) {
+        EXPECT_EQ(token_queue_peek(&queue, 2)->type,
+                  i + 2 >= 200 ? TOK_EOF : (i % 2 == 0 ? TOK_VAR : TOK_PLUS));
+        EXPECT_EQ(token_queue_advance(&queue).type, i % 2 == 0 ? TOK_VAR : TOK_PLUS);
+    }
+
+    // End of file is returned repeatedly
+    EXPECT_EQ(token_queue_peek(&queue, 5)->type, TOK_EOF);
+    EXPECT_EQ(token_queue_advance(&queue).type, TOK_EOF);
+    EXPECT_EQ(token_queue_advance(&queue).type, TOK_EOF);
+
+    token_queue_free(&queue);
+    scanner_free(&scanner);
+}
+
+TEST(TokenQueueTest, DeferredLexicalError) {
+    const char source[] = "<?php\n$a = #;";
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    auto queue = token_queue_new(&scanner);
+
+    // Error is only a token, it is reported when parser reaches it
+    EXPECT_EQ(token_queue_peek(&queue, 2)->type, TOK_ERROR);
+    EXPECT_EQ(token_queue_peek(&queue, 2)->attr.val_i, 1);
+    EXPECT_EQ(token_queue_peek(&queue, 10)->type, TOK_ERROR);
+    EXPECT_EQ(token_queue_advance(&queue).type, TOK_VAR);
+    EXPECT_EQ(token_queue_advance(&queue).type, TOK_ASSIGN);
+    EXPECT_EQ(token_queue_advance(&queue).type, TOK_ERROR);
+
+    token_queue_free(&queue);
+    scanner_free(&scanner);
+}
+
+TEST(SkipTest, VectorKernelsMatchScalar) {
+    typedef const char* (*skip_fn)(const char*, const char*);
+    const skip_fn fns[] = {skip_blank, skip_to_newline, skip_to_star, skip_string_body};
+    const int lengths[] = {0, 1, 15, 16, 17, 31, 32, 33};
+    const char stops[] = {'\n', '*', '"', '\\', '$', '\x01', 'a'};
+
+    // Inputs are kept as the scalar results are computed first
+    struct input_t {
+        std::string buf;
+        size_t start;
+        size_t len;
+    };
+    std::vector<input_t> inputs;
+    for (int len : lengths) {
+        for (char stop : stops) {
+            for (char filler : {' ', 'x'}) {
+                // Stop byte is the first / last one, just past a 16 / 32 byte block, or missing
+                for (int pos : {0, len - 1, 16, 32, -1}) {
+                    if (pos >= len) {
+                        continue;
+                    }
+                    for (size_t start : {0, 1}) {
+                        // Bytes after the end are stops, kernels mustn't look at them
+                        std::string buf(start + len + 64, stop);
+                        for (int i = 0; i < len; i++) {
+                            buf[start + i] = filler;
+                        }
+                        if (pos >= 0) {
+                            buf[start + pos] = stop;
+                            if (stop == '*' && pos + 1 < len) {
+                                buf[start + pos + 1] = '/';
+                            }
+                        }
+                        inputs.push_back({buf, start, (size_t)len});
+                    }
+                }
+            }
+        }
+    }
+
+    ASSERT_TRUE(skip_use(SKIP_IMPL_SCALAR));
+    std::vector<size_t> expected;
+    for (auto& input : inputs) {
+        const char* p = input.buf.data() + input.start;
+        for (skip_fn fn : fns) {
+            expected.push_back(fn(p, p + input.len) - p);
+        }
+    }
+
+    for (skip_impl_t impl : {SKIP_IMPL_SSE2, SKIP_IMPL_AVX2}) {
+        if (!skip_use(impl)) {
+            continue;
+        }
+        size_t k = 0;
+        for (auto& input : inputs) {
+            const char* p = input.buf.data() + input.start;
+            for (size_t f = 0; f < sizeof(fns) / sizeof(fns[0]); f++) {
+                EXPECT_EQ((size_t)(fns[f](p, p + input.len) - p), expected[k++])
+                    << "impl " << impl << ", kernel " << f << ", length " << input.len
+                    << ", input \"" << input.buf.substr(input.start, input.len) << "\"";
+            }
+        }
+    }
+
+    // Restore the best kernels for other tests
+    if (!skip_use(SKIP_IMPL_AVX2) && !skip_use(SKIP_IMPL_SSE2)) {
+        skip_use(SKIP_IMPL_SCALAR);
+    }
+}
+
+TEST(SourceTest, Locations) {
+    const char source[] = "<?php\n$a = 1;\n\n  /* two\nlines */ foo(\"x\\\"y\");";
+    auto scanner = scanner_new_from_buffer(source, strlen(source));
+    // Line and column of the last character of every token
+    const size_t expected[][2] = {{2, 2}, {2, 4}, {2, 6}, {2, 7}, {5, 12},
+                                  {5, 13}, {5, 19}, {5, 20}, {5, 21}, {5, 22}};
+    for (auto& location : expected) {
+        token_t token;
+        scanner_fill(&scanner, &token, 1);
+        size_t line_nr, col_nr;
+        source_location(&scanner.source, token.offset, &line_nr, &col_nr);
+        EXPECT_EQ(line_nr, location[0]) << token_to_string((token_type_t)token.type);
+        EXPECT_EQ(col_nr, location[1]) << token_to_string((token_type_t)token.type);
+    }
+    scanner_free(&scanner);
+}
+
+/**
+ * @brief Compare parallel lexing with serial lexing of the same source
+ */
+static void expect_same_as_serial(const std::string& source, unsigned threads) {
+    auto serial = scanner_new_from_buffer(source.c_str(), source.size());
+    auto parallel = scanner_new_from_buffer(source.c_str(), source.size());
+    size_t count;
+    token_t* tokens = scanner_lex_parallel(&parallel, threads, &count);
+
+    for (size_t i = 0; i < count; i++) {
+        token_t token;
+        scanner_fill(&serial, &token, 1);
+        ASSERT_EQ(tokens[i].type, token.type) << "token " << i << ", " << threads << " threads";
+        EXPECT_EQ(tokens[i].offset, token.offset) << "token " << i;
+        if (token.type == TOK_VAR || token.type == TOK_FUN_NAME || token.type == TOK_STR_LIT) {
+            EXPECT_EQ(tokens[i].attr.val_s, token.attr.val_s) << "token " << i;
+        } else if (token.type == TOK_INT_LIT || token.type == TOK_ERROR) {
+            EXPECT_EQ(tokens[i].attr.val_i, token.attr.val_i) << "token " << i;
+        }
+    }
+    EXPECT_TRUE(tokens[count - 1].type == TOK_EOF || tokens[count - 1].type == TOK_ERROR);
+    free(tokens);
+    scanner_free(&serial);
+    scanner_free(&parallel);
+}
+
+TEST(ParallelLexTest, SameAsSerial) {
+    // Several chunks, some of them starting inside multiline comments
+    std::string source = "<?php\n";
+    for (int i = 0; source.size() < 8 * SCANNER_PARALLEL_MIN_CHUNK; i++) {
+        source += "$var_" + std::to_string(i % 50) + " = foo(" + std::to_string(i) +
+                  ", 2.5e3, \"text\\n\");\n";
+        if (i % 1000 == 0) {
+            for (int j = 0; j < 3000; j++) {
+                source += "/* comment\n spanning * lines */ // and line comment\n";
+            }
+        }
+    }
+    // Invalid string literal in the middle stops lexing
+    std::string invalid = source;
+    invalid.insert(invalid.find('\n', invalid.size() / 2) + 1, "$bad = \"price $5\";\n");
+    for (unsigned threads : {1u, 2u, 3u, 8u, 13u}) {
+        expect_same_as_serial(source, threads);
+        expect_same_as_serial(invalid, threads);
+        expect_same_as_serial(source + "\n?>\n", threads);
+        expect_same_as_serial(source + "\n$a = \"unterminated\n$b;\n", threads);
+    }
+}
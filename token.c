@@ -11,12 +11,16 @@
 
 #include "token.h"
 #include <ctype.h>
+#include <inttypes.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "error.h"
+#include "str.h"
+
+_Static_assert(sizeof(token_t) == 16, "token_t has to fit in 16 bytes");
 
 bool is_valid_hex(char c) {
     return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
@@ -28,6 +32,7 @@ bool is_valid_octal(char c) {
 
 // Names for all token types
 const char* token_names[] = {[TOK_EOF] = "EOF",
+                             [TOK_ERROR] = "error",
                              [TOK_VAR] = "variable",
                              [TOK_STR_LIT] = "string literal",
                              [TOK_INT_LIT] = "integer literal",
@@ -71,17 +76,20 @@ const char* token_names[] = {[TOK_EOF] = "EOF",
                              [TOK_EXP_END] = "expression_end",
                              [TOK_E] = "expression(parser)"};
 
-void token_print(token_t* token) {
+void token_print(token_t* token, source_t* source) {
     const char* name = token_names[token->type];
 
-    fprintf(stderr, "[%zu:%zu]", token->line_nr, token->col_nr);
+    size_t line_nr, col_nr;
+    source_location(source, token->offset, &line_nr, &col_nr);
+    fprintf(stderr, "[%zu:%zu]", line_nr, col_nr);
 
     if (token->type == TOK_VAR || token->type == TOK_STR_LIT || token->type == TOK_FUN_NAME) {
-        fprintf(stderr, "{ %s, \"%s\" }\n", name, token->attr.val_s.val);
+        fprintf(stderr, "{ %s, \"%.*s\" }\n", name, (int)intern_len(token->attr.val_s),
+                token->attr.val_s);
     } else if (token->type == TOK_INT || token->type == TOK_FLOAT || token->type == TOK_STRING) {
         fprintf(stderr, "{ %s, %s }\n", name, token->attr.val_b ? "optional" : "required");
-    } else if (token->type == TOK_INT_LIT) {
-        fprintf(stderr, "{ %s, %d }\n", name, token->attr.val_i);
+    } else if (token->type == TOK_INT_LIT || token->type == TOK_ERROR) {
+        fprintf(stderr, "{ %s, %" PRId64 " }\n", name, token->attr.val_i);
     } else if (token->type == TOK_FLOAT_LIT) {
         fprintf(stderr, "{ %s, %f }\n", name, token->attr.val_f);
     } else if (token->type == TOK_BOOL_LIT) {
@@ -91,34 +99,51 @@ void token_print(token_t* token) {
     }
 }
 
-token_t token_new(token_type_t type, size_t line_nr, size_t col_nr) {
-    return (token_t){.type = type, .line_nr = line_nr, .col_nr = col_nr};
+token_t token_new(token_type_t type, uint32_t offset) {
+    return (token_t){.type = type, .offset = offset};
 }
 
-token_t token_new_with_string(token_type_t type, str_t* str, size_t line_nr, size_t col_nr) {
-    token_t token = {
-        .type = type, .attr.val_s = str_new_from_str(str), .line_nr = line_nr, .col_nr = col_nr};
-    str_clear(str);
-    return token;
+token_t token_new_with_string(token_type_t type, const char* val, size_t len, uint32_t offset) {
+    return (token_t){.type = type, .attr.val_s = intern(val, len), .offset = offset};
+}
+
+token_t token_new_with_hashed_string(token_type_t type, const char* val, size_t len,
+                                     uint32_t hash, uint32_t offset) {
+    return (token_t){.type = type, .attr.val_s = intern_hashed(val, len, hash), .offset = offset};
+}
+
+token_t token_new_with_raw_string(token_type_t type, uint32_t start, uint32_t len,
+                                  uint32_t offset) {
+    return (token_t){.type = type, .attr.raw = {.start = start, .len = len}, .offset = offset};
 }
 
-token_t token_new_with_string_literal(token_type_t type,
-                                      str_t* str,
-                                      size_t line_nr,
-                                      size_t col_nr) {
+token_t token_intern(token_t* token, const char* data) {
+    const char* val = data + token->attr.raw.start;
+    if (token->type == TOK_STR_LIT) {
+        return token_new_with_string_literal(token->type, val, token->attr.raw.len, token->offset);
+    }
+    return token_new_with_string(token->type, val, token->attr.raw.len, token->offset);
+}
+
+token_t token_new_with_string_literal(token_type_t type, const char* val, size_t len,
+                                      uint32_t offset) {
+    // Literals without escape sequences (and forbidden $) don't have to be processed
+    if (memchr(val, '\\', len) == NULL && memchr(val, '$', len) == NULL) {
+        return token_new_with_string(type, val, len, offset);
+    }
     str_t new_str = str_new();
 
     // Loop through all characters in the string literal
-    for (size_t i = 0; i < str->len; i++) {
+    for (size_t i = 0; i < len; i++) {
         // Escape sequences
-        if (str->val[i] == '\\') {
+        if (val[i] == '\\') {
             // Characters in hex format (e.g. \x42)
-            if (str->val[i + 1] == 'x') {
+            if (val[i + 1] == 'x') {
                 // Check if the next two characters are valid hex
-                if (i + 3 < str->len && is_valid_hex(str->val[i + 2]) &&
-                    is_valid_hex(str->val[i + 3])) {
+                if (i + 3 < len && is_valid_hex(val[i + 2]) &&
+                    is_valid_hex(val[i + 3])) {
                     // Convert the hex to a character
-                    char hex[3] = {str->val[i + 2], str->val[i + 3], '\0'};
+                    char hex[3] = {val[i + 2], val[i + 3], '\0'};
                     int number = (int)strtol(hex, NULL, 16);
                     // Check if the number is in the valid range
                     if (number >= 1 && number <= 255) {
@@ -133,12 +158,12 @@ token_t token_new_with_string_literal(token_type_t type,
                     str_add_char(&new_str, '\\');
                 }
                 // Characters in decimal format (e.g. \064)
-            } else if (is_valid_octal(str->val[i + 1])) {
+            } else if (is_valid_octal(val[i + 1])) {
                 // Check if the next three characters are valid decimal
-                if (i + 3 < str->len && is_valid_octal(str->val[i + 2]) &&
-                    is_valid_octal(str->val[i + 3])) {
+                if (i + 3 < len && is_valid_octal(val[i + 2]) &&
+                    is_valid_octal(val[i + 3])) {
                     // Convert the decimal to a character
-                    char num[4] = {str->val[i + 1], str->val[i + 2], str->val[i + 3], '\0'};
+                    char num[4] = {val[i + 1], val[i + 2], val[i + 3], '\0'};
                     int number = (int)strtol(num, NULL, 8);
                     // Check if the number is in the valid range
                     if (number >= 1 && number <= 255) {
@@ -154,7 +179,7 @@ token_t token_new_with_string_literal(token_type_t type,
                 }
                 // Other escape sequences
             } else {
-                switch (str->val[i + 1]) {
+                switch (val[i + 1]) {
                     case 'n':
                         str_add_char(&new_str, '\n');
                         break;
@@ -179,50 +204,45 @@ token_t token_new_with_string_literal(token_type_t type,
                     case '$':
                         str_add_char(&new_str, '$');
                         break;
+                    case '"':
+                        str_add_char(&new_str, '"');
+                        break;
                     default:
                         // If the escape sequence is not valid, just add it as is
                         str_add_char(&new_str, '\\');
-                        str_add_char(&new_str, str->val[i + 1]);
+                        str_add_char(&new_str, val[i + 1]);
                 }
                 i++;
             }
-        } else if (str->val[i] == '$') {
+        } else if (val[i] == '$') {
             // $ can't be used directly
-            error_exit(ERR_LEX);
+            str_free(&new_str);
+            return token_new_with_error(ERR_LEX, offset);
         } else {
             // Normal characters are added as is
-            str_add_char(&new_str, str->val[i]);
+            str_add_char(&new_str, val[i]);
         }
     }
 
-    str_clear(str);
-    return (token_t){.type = type, .attr.val_s = new_str, .line_nr = line_nr, .col_nr = col_nr};
+    token_t token = token_new_with_string(type, str_val(&new_str), str_len(&new_str), offset);
+    str_free(&new_str);
+    return token;
 }
 
-token_t token_new_with_int(token_type_t type, str_t* str, size_t line_nr, size_t col_nr) {
-    char* err;
-    long num = strtoul(str->val, &err, 10);
-    if (err == str->val || *err != '\0') {
-        error_exit(ERR_LEX);
-    }
-
-    str_clear(str);
-    return (token_t){.type = type, .attr.val_i = (int)num, .line_nr = line_nr, .col_nr = col_nr};
+token_t token_new_with_int(token_type_t type, int64_t val, uint32_t offset) {
+    return (token_t){.type = type, .attr.val_i = val, .offset = offset};
 }
 
-token_t token_new_with_float(token_type_t type, str_t* str, size_t line_nr, size_t col_nr) {
-    char* err;
-    double num = strtod(str->val, &err);
-    if (err == str->val || *err != '\0') {
-        error_exit(ERR_LEX);
-    }
+token_t token_new_with_float(token_type_t type, double val, uint32_t offset) {
+    return (token_t){.type = type, .attr.val_f = val, .offset = offset};
+}
 
-    str_clear(str);
-    return (token_t){.type = type, .attr.val_f = num, .line_nr = line_nr, .col_nr = col_nr};
+token_t token_new_with_bool(token_type_t type, bool val, uint32_t offset) {
+    return (token_t){.type = type, .attr.val_b = val, .offset = offset};
 }
 
-token_t token_new_with_bool(token_type_t type, bool val, size_t line_nr, size_t col_nr) {
-    return (token_t){.type = type, .attr.val_b = val, .line_nr = line_nr, .col_nr = col_nr};
+token_t token_new_with_error(int code, uint32_t offset) {
+    return (token_t){.type = TOK_ERROR, .attr.val_i = code, .offset = offset};
 }
 
 bool type_is_datatype(token_type_t type) {
@@ -248,12 +268,6 @@ bool type_is_comparator(token_type_t type) {
            type == TOK_EQUALS || type == TOK_NEQUALS;
 }
 
-void token_free(token_t* token) {
-    if (token->type == TOK_VAR || token->type == TOK_STR_LIT || token->type == TOK_FUN_NAME) {
-        str_free(&token->attr.val_s);
-    }
-}
-
 char* token_to_string(token_type_t type) {
     char* name = (char*)token_names[type];
     return name;
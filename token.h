@@ -12,7 +12,10 @@
 #ifndef __TOKEN_H__
 #define __TOKEN_H__
 
-#include "str.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "source.h"
+#include "intern.h"
 
 /**
  * @brief All token types
@@ -35,13 +38,14 @@ typedef enum {
     TOK_INT_LIT,       // Integer literal (eg. 0)
     TOK_FLOAT_LIT,     // Float literal (eg. 0.0)
     TOK_STR_LIT,       // String literal (eg. "foo")
-    TOK_NULL,          // Null
+    TOK_NULL,          // keyword: null
     TOK_DOLLAR,        // BOTTOM OF THE STACK (INTERNAL TO EXPR PARSING)
     TOK_HANDLE_START,  // HANDLE_START (INTERNAL TO EXPR PARSING)
     TOK_EXP_END,       // Expression end (Internal to expr parsing)
     TOK_E,             // expression (Internal to expr parsing)
 
     TOK_EOF,        // End of file
+    TOK_ERROR,      // Lexical error (reported when parser reaches it, code is in val_i)
     TOK_BOOL_LIT,   // Bool literal (eg. true)
     TOK_FUN_NAME,   // Function name (eg. write)
     TOK_COMMA,      // ,
@@ -51,19 +55,19 @@ typedef enum {
     TOK_LBRACE,     // {
     TOK_RBRACE,     // }
 
-    /* KEYWORDS */
-    TOK_ELSE,      // else
-    TOK_FLOAT,     // float
-    TOK_FUNCTION,  // function
-    TOK_IF,        // if
-    TOK_INT,       // int
-    TOK_RETURN,    // return
-    TOK_STRING,    // string
-    TOK_VOID,      // void
-    TOK_WHILE,     // while
-    TOK_FOR,       // for
-    TOK_BREAK,     // break
-    TOK_CONTINUE   // continue
+    /* KEYWORDS (items commented with "keyword: name", see tools/gen_keywords.c) */
+    TOK_ELSE,      // keyword: else
+    TOK_FLOAT,     // keyword: float
+    TOK_FUNCTION,  // keyword: function
+    TOK_IF,        // keyword: if
+    TOK_INT,       // keyword: int
+    TOK_RETURN,    // keyword: return
+    TOK_STRING,    // keyword: string
+    TOK_VOID,      // keyword: void
+    TOK_WHILE,     // keyword: while
+    TOK_FOR,       // keyword: for
+    TOK_BREAK,     // keyword: break
+    TOK_CONTINUE   // keyword: continue
     
 } token_type_t;
 
@@ -71,28 +75,32 @@ typedef enum {
  * @brief Token attribute
  */
 typedef union {
-    bool val_b;    // Bool value (for TOK_BOOL_LIT)
-    int val_i;     // Integer value (for TOK_INT_LIT)
-    double val_f;  // Float value (for TOK_FLOAT_LIT)
-    str_t val_s;   // String value (for TOK_STR_LIT, TOK_ID, TOK_FUN_NAME)
+    bool val_b;         // Bool value (for TOK_BOOL_LIT) or optional flag (for types)
+    int64_t val_i;      // Integer value (for TOK_INT_LIT) or error code (for TOK_ERROR)
+    double val_f;       // Float value (for TOK_FLOAT_LIT)
+    const char* val_s;  // Interned string (for TOK_STR_LIT, TOK_VAR, TOK_FUN_NAME), see intern_len
+    struct {
+        uint32_t start;  // Source offset of the raw string
+        uint32_t len;    // Length of the raw string
+    } raw;               // String which isn't interned yet (only in parallel workers)
 } token_attribute_t;
 
 /**
- * @brief Token struct
+ * @brief Token struct (16 bytes, strings are stored in the intern pool)
  */
 typedef struct {
-    token_type_t type;
+    uint8_t type;     // Token type (token_type_t)
+    uint32_t offset;  // Source offset right after the token (see source_location)
     token_attribute_t attr;
-    size_t line_nr;
-    size_t col_nr;
 } token_t;
 
 /**
  * @brief Print token in pretty format
  *
  * @param token Token to be printed
+ * @param source Source of the token (for line and column)
  */
-void token_print(token_t* token);
+void token_print(token_t* token, source_t* source);
 
 /**
  * @brief Create new token
@@ -100,43 +108,80 @@ void token_print(token_t* token);
  * @param type Token type
  * @return New token
  */
-token_t token_new(token_type_t type, size_t line_nr, size_t col_nr);
+token_t token_new(token_type_t type, uint32_t offset);
 
 /**
- * @brief Create new token with supplied string AND CONSUME THE STRING
+ * @brief Create new token with string (string is interned)
  *
  * @param type Token type
- * @param str String
- * @return New token with string
+ * @param val Characters (don't have to be null terminated)
+ * @param len Number of characters
+ * @return New token with interned string
  */
-token_t token_new_with_string(token_type_t type, str_t* str, size_t line_nr, size_t col_nr);
+token_t token_new_with_string(token_type_t type, const char* val, size_t len, uint32_t offset);
 
 /**
- * @brief Create new token with supplied string literal AND CONSUME THE STRING
+ * @brief Create new token with name whose hash was computed while scanning (name is interned)
+ *
+ * @param type Token type (TOK_VAR or TOK_FUN_NAME)
+ * @param val Characters (don't have to be null terminated)
+ * @param len Number of characters
+ * @param hash Hash of the characters (see intern_hash_step)
+ * @return New token with interned string
+ */
+token_t token_new_with_hashed_string(token_type_t type, const char* val, size_t len,
+                                     uint32_t hash, uint32_t offset);
+
+/**
+ * @brief Create new token from raw string literal body (escape sequences are processed and the
+ * result is interned)
  *
  * @param type Token type
- * @param str String
- * @return New token with string
+ * @param val Raw body of the literal (between quotes)
+ * @param len Length of the body
+ * @return New token with string (or error token if literal contains $ without backslash)
  */
-token_t token_new_with_string_literal(token_type_t type, str_t* str, size_t line_nr, size_t col_nr);
+token_t token_new_with_string_literal(token_type_t type, const char* val, size_t len,
+                                      uint32_t offset);
 
 /**
- * @brief Create new token with supplied string value of an int AND CONSUME THE STRING
+ * @brief Create new token with raw string which is interned later by token_intern (intern pool
+ * is not thread safe, so parallel workers can't intern)
+ *
+ * @param type Token type (TOK_STR_LIT, TOK_VAR or TOK_FUN_NAME)
+ * @param start Source offset of the string (literal body without quotes)
+ * @param len Length of the string
+ * @return New token with raw string
+ */
+token_t token_new_with_raw_string(token_type_t type, uint32_t start, uint32_t len,
+                                  uint32_t offset);
+
+/**
+ * @brief Intern raw string of the token (created by token_new_with_raw_string)
+ *
+ * @param token Token with raw string
+ * @param data Start of the source the raw string offset is relative to
+ * @return Token with interned string (or error token for invalid string literal)
+ */
+token_t token_intern(token_t* token, const char* data);
+
+/**
+ * @brief Create new token with int
  *
  * @param type Token type
- * @param str String
+ * @param val Int value
  * @return New token with int
  */
-token_t token_new_with_int(token_type_t type, str_t* str, size_t line_nr, size_t col_nr);
+token_t token_new_with_int(token_type_t type, int64_t val, uint32_t offset);
 
 /**
- * @brief Create new token with supplied string value of a float AND CONSUME THE STRING
+ * @brief Create new token with float
  *
  * @param type Token type
- * @param str String
+ * @param val Float value
  * @return New token with float
  */
-token_t token_new_with_float(token_type_t type, str_t* str, size_t line_nr, size_t col_nr);
+token_t token_new_with_float(token_type_t type, double val, uint32_t offset);
 
 /**
  * @brief Create new token with supplied bool
@@ -145,7 +190,15 @@ token_t token_new_with_float(token_type_t type, str_t* str, size_t line_nr, size
  * @param val Bool value
  * @return New token with bool
  */
-token_t token_new_with_bool(token_type_t type, bool val, size_t line_nr, size_t col_nr);
+token_t token_new_with_bool(token_type_t type, bool val, uint32_t offset);
+
+/**
+ * @brief Create new error token (lexical errors are reported only when parser reaches them)
+ *
+ * @param code Error code (enum return_code)
+ * @return New error token
+ */
+token_t token_new_with_error(int code, uint32_t offset);
 
 /**
  * @brief Check if token is a data type (eg. int, float, string)
@@ -171,13 +224,6 @@ bool token_is_literal(token_t* token);
  */
 bool token_is_expression(token_t* token);
 
-/**
- * @brief Free existing token
- *
- * @param token Token
- */
-void token_free(token_t* token);
-
 /**
  * @brief Print enum value as a string
  *
@@ -0,0 +1,101 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file token_queue.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Token queue (ring buffer between scanner and parser)
+ */
+
+#include "token_queue.h"
+#include <string.h>
+
+#define MASK (TOKEN_QUEUE_SIZE - 1)
+
+token_queue_t token_queue_new(scanner_t* scanner) {
+    return (token_queue_t){
+        .scanner = scanner, .lexed = NULL, .head = 0, .count = 0, .done = false};
+}
+
+token_queue_t token_queue_new_from_tokens(token_t* tokens, size_t count) {
+    return (token_queue_t){.scanner = NULL,
+                           .lexed = tokens,
+                           .lexed_count = count,
+                           .lexed_pos = 0,
+                           .head = 0,
+                           .count = 0,
+                           .done = false};
+}
+
+/**
+ * @brief Get next n tokens (from scanner or already lexed tokens)
+ *
+ * @param queue Token queue
+ * @param tokens Output array
+ * @param n Maximum number of tokens
+ * @return Number of tokens (less than n only if the last one is TOK_EOF or TOK_ERROR)
+ */
+static size_t token_queue_fill(token_queue_t* queue, token_t* tokens, size_t n) {
+    if (queue->scanner != NULL) {
+        return scanner_fill(queue->scanner, tokens, n);
+    }
+    size_t left = queue->lexed_count - queue->lexed_pos;
+    n = n < left ? n : left;
+    memcpy(tokens, &queue->lexed[queue->lexed_pos], n * sizeof(token_t));
+    queue->lexed_pos += n;
+    return n;
+}
+
+/**
+ * @brief Fill all free slots of the ring with new tokens
+ *
+ * @param queue Token queue
+ */
+static void token_queue_refill(token_queue_t* queue) {
+    while (queue->count < TOKEN_QUEUE_SIZE && !queue->done) {
+        // Free slots up to the end of the array (the rest is filled in next iteration)
+        size_t tail = (queue->head + queue->count) & MASK;
+        size_t space = TOKEN_QUEUE_SIZE - queue->count;
+        size_t n = TOKEN_QUEUE_SIZE - tail < space ? TOKEN_QUEUE_SIZE - tail : space;
+
+        size_t filled = token_queue_fill(queue, &queue->tokens[tail], n);
+        queue->count += filled;
+        if (filled < n) {
+            queue->done = true;
+        } else {
+            token_type_t last = queue->tokens[(tail + filled - 1) & MASK].type;
+            queue->done = last == TOK_EOF || last == TOK_ERROR;
+        }
+    }
+}
+
+token_t* token_queue_peek(token_queue_t* queue, size_t k) {
+    if (k >= queue->count) {
+        token_queue_refill(queue);
+        // Everything after end of file (or error) is the same token
+        if (k >= queue->count) {
+            k = queue->count - 1;
+        }
+    }
+    return &queue->tokens[(queue->head + k) & MASK];
+}
+
+token_t token_queue_advance(token_queue_t* queue) {
+    token_t token = *token_queue_peek(queue, 0);
+    // End of file (and error) stays in the queue, so it is returned again next time
+    if (token.type != TOK_EOF && token.type != TOK_ERROR) {
+        queue->head = (queue->head + 1) & MASK;
+        queue->count--;
+    }
+    return token;
+}
+
+void token_queue_free(token_queue_t* queue) {
+    queue->count = 0;
+    if (queue->lexed != NULL) {
+        free(queue->lexed);
+        queue->lexed = NULL;
+    }
+}
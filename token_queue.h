@@ -0,0 +1,74 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file token_queue.h
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Declaration of token queue (ring buffer between scanner and parser)
+ */
+
+#ifndef __TOKEN_QUEUE_H__
+#define __TOKEN_QUEUE_H__
+
+#include <stdbool.h>
+#include "scanner.h"
+#include "token.h"
+
+// Number of tokens in the ring (has to be power of two)
+#define TOKEN_QUEUE_SIZE 64
+
+typedef struct {
+    scanner_t* scanner;                // Scanner instance (NULL if tokens are already lexed)
+    token_t* lexed;                    // Already lexed tokens (used instead of scanner)
+    size_t lexed_count;                // Number of already lexed tokens
+    size_t lexed_pos;                  // Index of the next already lexed token
+    token_t tokens[TOKEN_QUEUE_SIZE];  // Ring of scanned tokens
+    size_t head;                       // Index of the first token
+    size_t count;                      // Number of tokens in the ring
+    bool done;                         // Was TOK_EOF or TOK_ERROR already scanned?
+} token_queue_t;
+
+/**
+ * @brief Initialize token queue
+ *
+ * @param scanner Scanner instance
+ * @return Initialized queue
+ */
+token_queue_t token_queue_new(scanner_t* scanner);
+
+/**
+ * @brief Initialize token queue over already lexed tokens (for example from scanner_lex_parallel)
+ *
+ * @param tokens Tokens, last one has to be TOK_EOF or TOK_ERROR (queue takes ownership)
+ * @param count Number of tokens
+ * @return Initialized queue
+ */
+token_queue_t token_queue_new_from_tokens(token_t* tokens, size_t count);
+
+/**
+ * @brief Look at token without removing it from the queue
+ *
+ * @param queue Token queue
+ * @param k Index of the token (0 = first), has to be less than TOKEN_QUEUE_SIZE
+ * @return Pointer to token (last token is TOK_EOF or TOK_ERROR, it is returned for all bigger k)
+ */
+token_t* token_queue_peek(token_queue_t* queue, size_t k);
+
+/**
+ * @brief Remove first token from the queue (TOK_EOF and TOK_ERROR are never removed)
+ *
+ * @param queue Token queue
+ * @return First token
+ */
+token_t token_queue_advance(token_queue_t* queue);
+
+/**
+ * @brief Free token queue (including remaining tokens)
+ *
+ * @param queue Token queue
+ */
+void token_queue_free(token_queue_t* queue);
+
+#endif  // __TOKEN_QUEUE_H__
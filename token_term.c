@@ -11,13 +11,9 @@
 
 #include "token_term.h"
 #include <stdio.h>
-#include "error.h"
 
-token_term_t* token_term_new(token_t value, bool terminal) {
-    token_term_t* new = malloc(sizeof(token_term_t));
-    if (!new) {
-        error_exit(ERR_INTERNAL);
-    }
+token_term_t* token_term_new(arena_t* arena, token_t value, bool terminal) {
+    token_term_t* new = arena_alloc(arena, sizeof(token_term_t));
     new->result = value.type;
     new->left = NULL;
     new->right = NULL;
@@ -48,17 +44,3 @@ void token_graph_print(token_term_t* token, int depth, int side) {
     token_graph_print(token->left, depth + 1, side * 2);
     token_graph_print(token->right, depth + 1, side * 2 + 1);
 }
-
-void token_term_free(token_term_t* root) {
-    if (!root) {
-        return;
-    }
-    token_term_free(root->left);
-    token_term_free(root->right);
-    root->left = NULL;
-    root->right = NULL;
-
-    token_free(&root->value);
-
-    free(root);
-}
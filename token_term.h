@@ -12,6 +12,7 @@
 #ifndef __TOKEN_TERM_H__
 #define __TOKEN_TERM_H__
 
+#include "arena.h"
 #include "token.h"
 
 typedef struct token_term {
@@ -25,12 +26,13 @@ typedef struct token_term {
 /**
  * @brief Creates new token_term_t with specified token and value of terminal
  *
+ * @param arena Arena of the expression (node lives until its reset)
  * @param token Token to be used
  * @param is_term Value whether token_term_t is or isn't terminal
  *
  * @return new instance of token_term_t
  */
-token_term_t* token_term_new(token_t value, bool terminal);
+token_term_t* token_term_new(arena_t* arena, token_t value, bool terminal);
 
 /**
  * @brief Pretty prints token_term_t
@@ -48,11 +50,4 @@ void token_term_pprint(token_term_t token);
  */
 void token_graph_print(token_term_t* token, int depth, int side);
 
-/**
- * @brief Frees token_term_t and all its children
- *
- * @param root Root token
- */
-void token_term_free(token_term_t* root);
-
 #endif
@@ -0,0 +1,192 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file gen_keywords.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Build step generating perfect hash for keywords (keywords.h) from token.h
+ *
+ * Every enum item in token.h whose comment is "keyword: " followed by the keyword is a keyword,
+ * for example "TOK_WHILE, // keyword: while".
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_KEYWORDS 64
+#define MAX_LEN 32
+#define KEYWORD_MARKER "keyword:"
+
+typedef struct {
+    char name[MAX_LEN];
+    char token[MAX_LEN];
+    size_t len;
+} keyword_t;
+
+keyword_t keywords[MAX_KEYWORDS];
+int keyword_count = 0;
+
+/**
+ * @brief Parse one line of token.h and remember it if it describes a keyword
+ *
+ * @param line Line from token.h
+ */
+void parse_line(char* line) {
+    // Skip indentation
+    while (isspace((unsigned char)*line)) {
+        line++;
+    }
+    if (strncmp(line, "TOK_", 4) != 0) {
+        return;
+    }
+
+    // Enum item name
+    size_t token_len = 0;
+    while (isalnum((unsigned char)line[token_len]) || line[token_len] == '_') {
+        token_len++;
+    }
+
+    // Comment has to be the keyword marker followed by exactly one lowercase word
+    char* comment = strstr(line, "//");
+    if (comment == NULL) {
+        return;
+    }
+    comment += 2;
+    while (isspace((unsigned char)*comment)) {
+        comment++;
+    }
+    if (strncmp(comment, KEYWORD_MARKER, strlen(KEYWORD_MARKER)) != 0) {
+        return;
+    }
+    comment += strlen(KEYWORD_MARKER);
+    while (isspace((unsigned char)*comment)) {
+        comment++;
+    }
+    size_t name_len = 0;
+    while (islower((unsigned char)comment[name_len])) {
+        name_len++;
+    }
+    for (char* rest = comment + name_len; *rest != '\0'; rest++) {
+        if (!isspace((unsigned char)*rest)) {
+            name_len = 0;
+            break;
+        }
+    }
+    if (name_len == 0 || name_len >= MAX_LEN || token_len >= MAX_LEN) {
+        fprintf(stderr, "gen_keywords: invalid keyword marker: %s", line);
+        exit(1);
+    }
+    if (keyword_count == MAX_KEYWORDS) {
+        fprintf(stderr, "gen_keywords: too many keywords\n");
+        exit(1);
+    }
+
+    keyword_t* keyword = &keywords[keyword_count++];
+    memcpy(keyword->name, comment, name_len);
+    keyword->name[name_len] = '\0';
+    memcpy(keyword->token, line, token_len);
+    keyword->token[token_len] = '\0';
+    keyword->len = name_len;
+}
+
+/**
+ * @brief Hash mixing length with first and last character (same formula as in the output)
+ */
+unsigned hash(const keyword_t* keyword, unsigned a, unsigned b, unsigned mask) {
+    unsigned char first = keyword->name[0];
+    unsigned char last = keyword->name[keyword->len - 1];
+    return (keyword->len + first * a + last * b) & mask;
+}
+
+/**
+ * @brief Check if parameters give hash without collisions
+ */
+bool is_perfect(unsigned a, unsigned b, unsigned mask) {
+    bool used[256] = {false};
+    for (int i = 0; i < keyword_count; i++) {
+        unsigned h = hash(&keywords[i], a, b, mask);
+        if (used[h]) {
+            return false;
+        }
+        used[h] = true;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s token.h\n", argv[0]);
+        return 1;
+    }
+    FILE* input = fopen(argv[1], "r");
+    if (input == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), input) != NULL) {
+        parse_line(line);
+    }
+    fclose(input);
+
+    if (keyword_count == 0) {
+        fprintf(stderr, "gen_keywords: no keywords found\n");
+        return 1;
+    }
+
+    // Find smallest table and smallest multipliers without collisions
+    for (unsigned size = 16; size <= 256; size *= 2) {
+        for (unsigned a = 1; a < 64; a++) {
+            for (unsigned b = 0; b < 64; b++) {
+                if (!is_perfect(a, b, size - 1)) {
+                    continue;
+                }
+
+                size_t min_len = MAX_LEN, max_len = 0;
+                for (int i = 0; i < keyword_count; i++) {
+                    min_len = keywords[i].len < min_len ? keywords[i].len : min_len;
+                    max_len = keywords[i].len > max_len ? keywords[i].len : max_len;
+                }
+
+                printf("// Generated by tools/gen_keywords from token.h, do not edit\n\n");
+                printf("#ifndef __KEYWORDS_H__\n#define __KEYWORDS_H__\n\n");
+                printf("#include <string.h>\n#include \"token.h\"\n\n");
+                printf("#define KEYWORD_MIN_LEN %zu\n", min_len);
+                printf("#define KEYWORD_MAX_LEN %zu\n\n", max_len);
+                printf("// Hash table indexed by (len + first * %u + last * %u) & %u\n", a, b,
+                       size - 1);
+                printf("static const struct {\n    const char* name;\n    size_t len;\n");
+                printf("    token_type_t type;\n} keyword_table[%u] = {\n", size);
+                for (int i = 0; i < keyword_count; i++) {
+                    printf("    [%u] = {\"%s\", %zu, %s},\n", hash(&keywords[i], a, b, size - 1),
+                           keywords[i].name, keywords[i].len, keywords[i].token);
+                }
+                printf("};\n\n");
+                printf("/**\n * @brief Find keyword token type\n *\n");
+                printf(" * @param str Identifier (doesn't have to be null terminated)\n");
+                printf(" * @param len Identifier length\n");
+                printf(" * @return Keyword token type or -1 if identifier is not keyword\n */\n");
+                printf("static inline int keyword_lookup(const char* str, size_t len) {\n");
+                printf("    if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN) {\n");
+                printf("        return -1;\n    }\n");
+                printf("    unsigned h = (len + (unsigned char)str[0] * %uu +\n", a);
+                printf("                  (unsigned char)str[len - 1] * %uu) & %uu;\n", b,
+                       size - 1);
+                printf("    if (keyword_table[h].len != len || "
+                       "memcmp(keyword_table[h].name, str, len) != 0) {\n");
+                printf("        return -1;\n    }\n");
+                printf("    return keyword_table[h].type;\n}\n\n");
+                printf("#endif  // __KEYWORDS_H__\n");
+                return 0;
+            }
+        }
+    }
+
+    fprintf(stderr, "gen_keywords: no perfect hash found\n");
+    return 1;
+}
@@ -0,0 +1,149 @@
+/**
+ * Implementace překladače imperativního jazyka IFJ22
+ *
+ * @file gen_pow5.c
+ * @author Josef Kuchař (xkucha28@stud.fit.vutbr.cz)
+ * @author Matej Sirovatka (xsirov00@stud.fit.vutbr.cz)
+ * @author Tomáš Běhal (xbehal02@stud.fit.vutbr.cz)
+ * @author Šimon Benčík (xbenci01@stud.fit.vutbr.cz)
+ * @brief Build step generating 128-bit powers of five (pow5.h) for the Eisel-Lemire algorithm
+ *
+ * For every q in [POW5_MIN_EXP, POW5_MAX_EXP] the table contains 5^q normalized to 128 bits
+ * (most significant bit set). Negative powers are reciprocals rounded up, same as in the paper
+ * "Number Parsing at a Gigabyte per Second" by D. Lemire.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MIN_EXP -342
+#define MAX_EXP 308
+
+// Enough for 2^(2 * 796 + 128)
+#define WORDS 64
+
+typedef struct {
+    uint32_t w[WORDS];  // Little endian words
+} big_t;
+
+void big_set(big_t* a, uint32_t value) {
+    memset(a, 0, sizeof(*a));
+    a->w[0] = value;
+}
+
+void big_mul(big_t* a, uint32_t m) {
+    uint64_t carry = 0;
+    for (int i = 0; i < WORDS; i++) {
+        uint64_t x = (uint64_t)a->w[i] * m + carry;
+        a->w[i] = (uint32_t)x;
+        carry = x >> 32;
+    }
+}
+
+void big_shl1(big_t* a, uint32_t bit) {
+    for (int i = WORDS - 1; i > 0; i--) {
+        a->w[i] = (a->w[i] << 1) | (a->w[i - 1] >> 31);
+    }
+    a->w[0] = (a->w[0] << 1) | bit;
+}
+
+void big_shr1(big_t* a) {
+    for (int i = 0; i < WORDS - 1; i++) {
+        a->w[i] = (a->w[i] >> 1) | (a->w[i + 1] << 31);
+    }
+    a->w[WORDS - 1] >>= 1;
+}
+
+int big_cmp(const big_t* a, const big_t* b) {
+    for (int i = WORDS - 1; i >= 0; i--) {
+        if (a->w[i] != b->w[i]) {
+            return a->w[i] < b->w[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+void big_sub(big_t* a, const big_t* b) {
+    int64_t borrow = 0;
+    for (int i = 0; i < WORDS; i++) {
+        int64_t x = (int64_t)a->w[i] - b->w[i] - borrow;
+        borrow = x < 0;
+        a->w[i] = (uint32_t)(x + (borrow << 32));
+    }
+}
+
+void big_inc(big_t* a) {
+    for (int i = 0; i < WORDS && ++a->w[i] == 0; i++) {
+    }
+}
+
+/**
+ * @brief Number of significant bits
+ */
+int big_bits(const big_t* a) {
+    for (int i = WORDS - 1; i >= 0; i--) {
+        if (a->w[i] != 0) {
+            return i * 32 + 32 - __builtin_clz(a->w[i]);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Print highest 128 bits of number with exactly 128 significant bits
+ */
+void print_128(const big_t* a, int q) {
+    uint64_t high = ((uint64_t)a->w[3] << 32) | a->w[2];
+    uint64_t low = ((uint64_t)a->w[1] << 32) | a->w[0];
+    printf("    0x%016llxu, 0x%016llxu,  // 5^%d\n", (unsigned long long)high,
+           (unsigned long long)low, q);
+}
+
+int main() {
+    printf("// Generated by tools/gen_pow5, do not edit\n\n");
+    printf("#ifndef __POW5_H__\n#define __POW5_H__\n\n#include <stdint.h>\n\n");
+    printf("#define POW5_MIN_EXP (%d)\n#define POW5_MAX_EXP %d\n\n", MIN_EXP, MAX_EXP);
+    printf("// 5^q normalized to 128 bits (high and low half) for q from POW5_MIN_EXP\n");
+    printf("static const uint64_t pow5_128[%d] = {\n", 2 * (MAX_EXP - MIN_EXP + 1));
+
+    for (int q = MIN_EXP; q <= MAX_EXP; q++) {
+        big_t power;
+        big_set(&power, 1);
+        for (int i = 0; i < (q < 0 ? -q : q); i++) {
+            big_mul(&power, 5);
+        }
+
+        big_t c;
+        if (q >= 0) {
+            c = power;
+            while (big_bits(&c) < 128) {
+                big_shl1(&c, 0);
+            }
+        } else {
+            // c = 2^b / 5^-q + 1 (long division bit by bit)
+            int z = big_bits(&power);
+            int b = q >= -27 ? z + 127 : 2 * z + 128;
+            big_t remainder;
+            big_set(&remainder, 0);
+            big_set(&c, 0);
+            for (int bit = b; bit >= 0; bit--) {
+                big_shl1(&remainder, bit == b);
+                big_shl1(&c, 0);
+                if (big_cmp(&remainder, &power) >= 0) {
+                    big_sub(&remainder, &power);
+                    c.w[0] |= 1;
+                }
+            }
+            big_inc(&c);
+        }
+        while (big_bits(&c) > 128) {
+            big_shr1(&c);
+        }
+        print_128(&c, q);
+    }
+
+    printf("};\n\n#endif  // __POW5_H__\n");
+    return 0;
+}